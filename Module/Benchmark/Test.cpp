@@ -0,0 +1,477 @@
+//==============================================================================
+// Minamoto : Test Source
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#include <Runtime.h>
+#include <xxGraphicPlus/xxFile.h>
+#include <xxGraphicPlus/xxTexture.h>
+#include <Graphic/Node.h>
+#include <Graphic/Shader.h>
+#include <Graphic/Texture.h>
+#include <Tools/NodeTools.h>
+#include "Test.h"
+
+#define TAG "Test"
+
+#define CHECK(condition) \
+    if ((condition) == false) \
+    { \
+        xxLog(TAG, "%s(%d) : %s", __FUNCTION__, __LINE__, #condition); \
+        succeed = false; \
+    }
+
+//==============================================================================
+//  Shader
+//==============================================================================
+static std::vector<std::string> compiledShaders;
+static std::vector<std::string> createdShaders;
+static bool rejectBlob;
+//------------------------------------------------------------------------------
+static std::string CompileTest(char const* backend, char const* shader, int type)
+{
+    compiledShaders.push_back(shader);
+
+    // Binary blobs carry NULs, so the size must travel with the data
+    return std::string("BLOB", 5) + shader;
+}
+//------------------------------------------------------------------------------
+static uint64_t CreateTest(char const* shader)
+{
+    createdShaders.push_back(shader);
+    return createdShaders.size();
+}
+//------------------------------------------------------------------------------
+static uint64_t CreateBlobTest(uint64_t device, void const* blob, size_t size, int type, uint64_t vertexAttribute)
+{
+    if (rejectBlob)
+        return 0;
+    createdShaders.emplace_back(static_cast<char const*>(blob), size);
+    return createdShaders.size();
+}
+//------------------------------------------------------------------------------
+static uint64_t xxCreateVertexShaderTest(uint64_t device, char const* shader, uint64_t vertexAttribute)
+{
+    return CreateTest(shader);
+}
+//------------------------------------------------------------------------------
+static uint64_t xxCreateFragmentShaderTest(uint64_t device, char const* shader)
+{
+    return CreateTest(shader);
+}
+//------------------------------------------------------------------------------
+static void xxDestroyShaderTest(uint64_t device, uint64_t shader)
+{
+}
+//------------------------------------------------------------------------------
+static bool TestShader(uint64_t device)
+{
+    bool succeed = true;
+
+    std::string path = std::string(xxGetDocumentPath()) + "/.minamoto.test.shader";
+    std::string cachePath = Shader::CachePath;
+    auto compile = Shader::Compile;
+    auto create = Shader::Create;
+    remove(path.c_str());
+
+    // Run against recording stubs under the NULL device
+    Shader::Shutdown();
+    auto createVertexShader = xxCreateVertexShader;
+    auto createFragmentShader = xxCreateFragmentShader;
+    auto destroyShader = xxDestroyShader;
+    xxCreateVertexShader = xxCreateVertexShaderTest;
+    xxCreateFragmentShader = xxCreateFragmentShaderTest;
+    xxDestroyShader = xxDestroyShaderTest;
+    Shader::CachePath = path;
+    Shader::Compile = CompileTest;
+    Shader::Create = CreateBlobTest;
+    Shader::ClearCache();
+
+    // Miss
+    Shader::Initialize();
+    xxCreateVertexShader(device, "A", 0);
+    xxCreateVertexShader(device, "A", 0);
+    CHECK(Shader::CacheMiss == 1);
+    CHECK(Shader::CacheHit == 0);
+    CHECK(compiledShaders.size() == 1);
+    CHECK(createdShaders.size() == 1 && createdShaders.back() == std::string("BLOB\0A", 6));
+    Shader::Shutdown();
+
+    // Hit
+    Shader::ClearCache();
+    compiledShaders.clear();
+    Shader::Initialize();
+    xxCreateVertexShader(device, "A", 0);
+    CHECK(Shader::CacheHit == 1);
+    CHECK(Shader::CacheMiss == 0);
+    CHECK(compiledShaders.empty());
+    CHECK(createdShaders.back() == std::string("BLOB\0A", 6));
+
+    // Invalidation by source and stage
+    xxCreateVertexShader(device, "B", 0);
+    xxCreateFragmentShader(device, "A");
+    CHECK(Shader::CacheHit == 1);
+    CHECK(Shader::CacheMiss == 2);
+    CHECK(compiledShaders.size() == 2);
+    Shader::Shutdown();
+
+    // Invalidation by a backend rejecting the cached blob
+    Shader::ClearCache();
+    compiledShaders.clear();
+    rejectBlob = true;
+    Shader::Initialize();
+    xxCreateVertexShader(device, "A", 0);
+    CHECK(Shader::CacheHit == 0);
+    CHECK(Shader::CacheMiss == 1);
+    CHECK(createdShaders.back() == "A");
+    xxCreateVertexShader(device, "C", 0);
+    CHECK(compiledShaders.size() == 1);
+    Shader::Shutdown();
+    rejectBlob = false;
+
+    // Keyed by backend
+    CHECK(Shader::Hash("NULL", "A", 'vert') != Shader::Hash("Direct3D 11", "A", 'vert'));
+
+    // Inactive without the blob path
+    Shader::ClearCache();
+    compiledShaders.clear();
+    Shader::Create = nullptr;
+    Shader::Initialize();
+    xxCreateVertexShader(device, "A", 0);
+    CHECK(Shader::CacheHit == 0);
+    CHECK(compiledShaders.empty());
+    CHECK(createdShaders.back() == "A");
+    Shader::Shutdown();
+    Shader::Create = CreateBlobTest;
+
+    // Invalidation by version
+    xxFile* file = xxFile::Save(path.c_str());
+    if (file)
+    {
+        uint32_t header[4] = { "SHDC"_cc, Shader::CacheVersion - 1, 0, 0 };
+        file->Write(header, sizeof(header));
+        delete file;
+    }
+    Shader::ClearCache();
+    CHECK(Shader::LoadCache(path.c_str()) == false);
+
+    // Restore
+    xxCreateVertexShader = createVertexShader;
+    xxCreateFragmentShader = createFragmentShader;
+    xxDestroyShader = destroyShader;
+    Shader::CachePath = cachePath;
+    Shader::Compile = compile;
+    Shader::Create = create;
+    Shader::ClearCache();
+    Shader::Initialize();
+    compiledShaders.clear();
+    createdShaders.clear();
+    remove(path.c_str());
+
+    return succeed;
+}
+//==============================================================================
+//  Object
+//==============================================================================
+static bool TestObject(uint64_t device)
+{
+    bool succeed = true;
+
+    // Scene root with two imported characters sharing bone names
+    xxNodePtr scene = xxNode::Create();
+    scene->Name = "Scene";
+    xxNodePtr characters[2];
+    for (xxNodePtr& character : characters)
+    {
+        character = xxNode::Create();
+        character->Name = "Character";
+        scene->AttachChild(character);
+        xxNodePtr parent = character;
+        for (int i = 0; i < 8; ++i)
+        {
+            xxNodePtr bone = xxNode::Create();
+            bone->Name = "Bone" + std::to_string(i);
+            parent->AttachChild(bone);
+            parent = bone;
+        }
+    }
+    NodeTools::GetObject(scene, "Scene");
+
+    // Lookups through a parented subtree stay inside it
+    xxNodePtr bone = NodeTools::GetObject(characters[1], "Bone3");
+    CHECK(bone && bone->Name == "Bone3");
+    CHECK(bone && NodeTools::GetRoot(bone) == scene);
+    CHECK(bone && bone->GetParent()->GetParent()->GetParent()->GetParent() == characters[1]);
+    CHECK(NodeTools::GetObject(characters[1]->GetChild(0), "Bone0") == characters[1]->GetChild(0));
+    CHECK(NodeTools::GetObject(characters[0]->GetChild(0)->GetChild(0), "Bone0") == nullptr);
+    CHECK(NodeTools::GetObject(characters[0], "Scene") == nullptr);
+
+    // Renames and moves below a parented subtree
+    bone->SetName("Renamed");
+    CHECK(NodeTools::GetObject(characters[1], "Renamed") == bone);
+    CHECK(NodeTools::GetObject(characters[1], "Bone3") == nullptr);
+    CHECK(NodeTools::GetObject(characters[0], "Bone3") != nullptr);
+    bone->GetParent()->DetachChild(bone);
+    characters[0]->AttachChild(bone);
+    CHECK(NodeTools::GetObject(characters[1], "Renamed") == nullptr);
+    CHECK(NodeTools::GetObject(characters[0], "Renamed") == bone);
+    CHECK(NodeTools::GetObject(characters[1], "Bone5") == nullptr);
+    CHECK(NodeTools::GetObject(bone, "Bone5") == bone->GetChild(0)->GetChild(0));
+
+    // Duplicated names keep the first match in depth-first order
+    xxNodePtr duplicate = NodeTools::GetObject(characters[0], "Bone5");
+    CHECK(duplicate && duplicate != bone->GetChild(0)->GetChild(0));
+
+    return succeed;
+}
+//==============================================================================
+//  Texture
+//==============================================================================
+static bool TestTexture(uint64_t device)
+{
+    bool succeed = true;
+
+    // 256x256 BC1 with every level filled by its index + 1
+    std::string path = xxGetDocumentPath();
+    std::string name = ".minamoto.test.dds";
+    xxTexturePtr source = xxTexture::Create("BC1"_cc, 256, 256, 1, 9, 1);
+    size_t fullBytes = 0;
+    size_t tailBytes = 0;
+    for (int mipmap = 0; mipmap < source->Mipmap; ++mipmap)
+    {
+        size_t size = Texture::Calculate("BC1"_cc, std::max(256 >> mipmap, 1), std::max(256 >> mipmap, 1), 1);
+        memset((*source)(0, 0, 0, mipmap), mipmap + 1, size);
+        fullBytes += size;
+        tailBytes += mipmap >= 2 ? size : 0;
+    }
+    Texture::DDSWriter(source, path + '/' + name);
+
+    // Only the 64x64 tail is read at load
+    Texture::SetStreaming(true, fullBytes);
+    xxTexturePtr texture = xxTexture::Create();
+    texture->Name = name;
+    Texture::Loader(texture, path);
+    Texture::Reader(texture);
+    CHECK(Texture::GetResidentMipmap(texture) == 2);
+    CHECK(texture->Width == 64 && texture->Height == 64 && texture->Mipmap == 7);
+    CHECK((*texture)() && *(char*)(*texture)(0, 0, 0, 0) == 3);
+    Texture::Update();
+    Texture::StreamingStatistics statistics = Texture::GetStreamingStatistics();
+    CHECK(statistics.textureCount == 1);
+    CHECK(statistics.residentBytes == tailBytes);
+    CHECK(statistics.budgetBytes == fullBytes);
+    CHECK(statistics.pendingCount == 0);
+
+    // Drawn at full size, the finer levels arrive through the loader
+    Texture::Stream(texture, 256.0f);
+    Texture::Update();
+    CHECK(Texture::GetStreamingStatistics().pendingCount == 1);
+    for (int i = 0; i < 1000 && Texture::GetResidentMipmap(texture) != 0; ++i)
+    {
+        xxSleep(1);
+        Texture::Stream(texture, 256.0f);
+        Texture::Update();
+    }
+    Texture::Update();
+    statistics = Texture::GetStreamingStatistics();
+    CHECK(Texture::GetResidentMipmap(texture) == 0);
+    CHECK(texture->Width == 256 && texture->Height == 256 && texture->Mipmap == 9);
+    CHECK((*texture)() && *(char*)(*texture)(0, 0, 0, 0) == 1 && *(char*)(*texture)(0, 0, 0, 8) == 9);
+    CHECK(statistics.residentBytes == fullBytes);
+    CHECK(statistics.pendingCount == 0);
+    CHECK(statistics.loadCount == 1);
+    CHECK(statistics.requestCount >= 2);
+    CHECK(statistics.evictCount == 0);
+
+    // Out of view under a smaller budget, the least recently used levels are evicted down to the tail
+    Texture::SetStreaming(true, tailBytes);
+    for (int i = 0; i < 3; ++i)
+    {
+        Texture::Update();
+    }
+    statistics = Texture::GetStreamingStatistics();
+    CHECK(Texture::GetResidentMipmap(texture) == 2);
+    CHECK(texture->Width == 64 && texture->Height == 64 && texture->Mipmap == 7);
+    CHECK((*texture)() && *(char*)(*texture)(0, 0, 0, 0) == 3);
+    CHECK(statistics.residentBytes == tailBytes);
+    CHECK(statistics.budgetBytes == tailBytes);
+    CHECK(statistics.evictCount == 1);
+
+    Texture::SetStreaming(false);
+    CHECK(Texture::GetStreamingStatistics().textureCount == 0);
+    remove((path + '/' + name).c_str());
+
+    return succeed;
+}
+//==============================================================================
+//  Update
+//==============================================================================
+static xxNodePtr CreateSkeleton(int index)
+{
+    xxNodePtr character = xxNode::Create();
+    character->SetTranslate({ float(index), 0.0f, 0.0f });
+    character->UpdateRotateTranslateScale();
+
+    // Skeleton as a binary tree
+    std::vector<xxNodePtr> bones;
+    for (int i = 0; i < 31; ++i)
+    {
+        float angle = (index * 31 + i) * 0.1f;
+        xxNodePtr bone = xxNode::Create();
+        bone->SetRotate(xxMatrix3::Quaternion({ sinf(angle) * 0.6f, 0.0f, sinf(angle) * 0.8f, cosf(angle) }));
+        bone->SetTranslate({ 0.25f, 1.0f, float(i % 3) });
+        bone->SetScale(1.0f + (i % 4) * 0.125f);
+        bone->UpdateRotateTranslateScale();
+        (i ? bones[(i - 1) / 2] : character)->AttachChild(bone);
+        bones.push_back(bone);
+    }
+
+    // Skin
+    xxNodePtr skin = xxNode::Create();
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        xxNode::BoneData data;
+        data.bone = bones[i];
+        data.bound = xxVector4::ZERO;
+        data.classSkinMatrix = xxMatrix4::IDENTITY;
+        data.classSkinMatrix.v[3] = { float(i), 0.5f, -1.0f, 1.0f };
+        data.classBoneMatrix = {};
+        skin->Bones.push_back(data);
+    }
+    for (auto& data : skin->Bones)
+    {
+        data.ResetPointer();
+    }
+    character->AttachChild(skin);
+
+    return character;
+}
+//------------------------------------------------------------------------------
+static void CaptureMatrix(xxNodePtr const& root, std::vector<xxMatrix4>& matrices, bool clear)
+{
+    matrices.clear();
+    Node::Visit(root, [&](Node* node)
+    {
+        matrices.push_back(node->WorldMatrix);
+        for (auto& data : node->Bones)
+        {
+            matrices.push_back(data.boneMatrix);
+            if (clear)
+                data.boneMatrix = {};
+        }
+        if (clear)
+        {
+            node->WorldMatrix = {};
+            node->Flags |= Node::UPDATE_DIRTY;
+        }
+        return true;
+    });
+}
+//------------------------------------------------------------------------------
+static bool ExactMatrix(std::vector<xxMatrix4> const& a, std::vector<xxMatrix4> const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            xxVector4 const& l = a[i].v[j];
+            xxVector4 const& r = b[i].v[j];
+            if (l.x != r.x || l.y != r.y || l.z != r.z || l.w != r.w)
+                return false;
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+static bool TestUpdate(uint64_t device)
+{
+    bool succeed = true;
+
+    xxNodePtr root = xxNode::Create();
+    std::vector<Node*> nodes;
+    for (int i = 0; i < 64; ++i)
+    {
+        xxNodePtr character = CreateSkeleton(i);
+        root->AttachChild(character);
+        nodes.push_back(character.get());
+    }
+
+    std::vector<xxMatrix4> reference;
+    std::vector<xxMatrix4> matrices;
+    for (bool independent : { true, false })
+    {
+        // Scalar
+        for (Node* node : nodes)
+            node->Update(1.0f);
+        CaptureMatrix(root, reference, true);
+
+        // Batched
+        NodeTools::Update(nodes, 1.0f);
+        CaptureMatrix(root, matrices, false);
+        CHECK(ExactMatrix(reference, matrices));
+
+        // Bones outside the subtree switch to the serial path
+        if (independent)
+        {
+            xxNodePtr const& skin = nodes.back()->GetChild(nodes.back()->GetChildCount() - 1);
+            skin->Bones.front().bone = nodes.front()->GetChild(0);
+        }
+    }
+
+    // Only the subtrees below changed nodes are recomputed
+    xxNodePtr const& changed = nodes[3]->GetChild(0)->GetChild(1);
+    xxNodePtr const& clean = nodes[4]->GetChild(0);
+    changed->SetTranslate({ 0.5f, 2.0f, -1.0f });
+    changed->UpdateRotateTranslateScale();
+    CHECK(changed->Flags & Node::UPDATE_DIRTY);
+    for (Node* node : nodes)
+        node->Update(1.0f);
+    CaptureMatrix(changed, reference, false);
+    Node::Visit(changed, [](Node* node)
+    {
+        node->WorldMatrix = {};
+        return true;
+    });
+    clean->WorldMatrix = {};
+    NodeTools::Update(nodes, 1.0f);
+    CaptureMatrix(changed, matrices, false);
+    CHECK(ExactMatrix(reference, matrices));
+    CHECK((changed->Flags & Node::UPDATE_DIRTY) == 0);
+    CHECK(clean->WorldMatrix.v[3].w == 0.0f);
+
+    return succeed;
+}
+//==============================================================================
+//  Test
+//==============================================================================
+bool Test(char const* name, uint64_t device)
+{
+    struct { char const* name; bool (*test)(uint64_t device); } const tests[] =
+    {
+        { "object", TestObject },
+        { "shader", TestShader },
+        { "texture", TestTexture },
+        { "update", TestUpdate },
+    };
+
+    bool succeed = true;
+    bool found = false;
+    for (auto const& test : tests)
+    {
+        if (strcmp(name, "all") != 0 && strcmp(name, test.name) != 0)
+            continue;
+        found = true;
+        bool result = test.test(device);
+        xxLog(TAG, "%s : %s", test.name, result ? "Passed" : "Failed");
+        succeed &= result;
+    }
+    if (found == false)
+    {
+        xxLog(TAG, "%s is not found", name);
+        return false;
+    }
+    return succeed;
+}
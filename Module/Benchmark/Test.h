@@ -0,0 +1,9 @@
+//==============================================================================
+// Minamoto : Test Header
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#pragma once
+
+bool Test(char const* name, uint64_t device);
@@ -0,0 +1,429 @@
+//==============================================================================
+// Minamoto : Benchmark Source
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#include <Runtime.h>
+#include <algorithm>
+#include <xxGraphic/xxGraphicNULL.h>
+#include <xxGraphicPlus/xxFile.h>
+#include <Graphic/Binary.h>
+#include <Graphic/Buffer.h>
+#include <Graphic/Camera.h>
+#include <Graphic/Material.h>
+#include <Graphic/Mesh.h>
+#include <Graphic/Node.h>
+#include <Modifier/Interpolated/InterpolatedQuaternionModifier.h>
+#include <Tools/DrawTools.h>
+#include <Tools/JobSystem.h>
+#include <Tools/NodeTools.h>
+#include "Test.h"
+
+#define TAG "Benchmark"
+
+static int const KEY_COUNT = 30;
+static int const WIDTH = 1280;
+static int const HEIGHT = 720;
+
+//==============================================================================
+//  Option
+//==============================================================================
+struct Option
+{
+    char const* scene = nullptr;
+    char const* output = nullptr;
+    char const* test = nullptr;
+    int frames = 600;
+    int warmup = 60;
+    int groups = 1000;
+    int size = 100;
+    int threads = 0;
+    unsigned int seed = 1;
+    float step = 1.0f / 60.0f;
+};
+//------------------------------------------------------------------------------
+static bool ParseOption(Option& option, int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        char const* name = argv[i];
+        char const* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr)
+            return false;
+        switch (xxHash(name))
+        {
+        case xxHash("--scene"):     option.scene = value;                           break;
+        case xxHash("--output"):    option.output = value;                          break;
+        case xxHash("--test"):      option.test = value;                            break;
+        case xxHash("--frames"):    option.frames = std::max(atoi(value), 1);       break;
+        case xxHash("--warmup"):    option.warmup = std::max(atoi(value), 0);       break;
+        case xxHash("--groups"):    option.groups = std::max(atoi(value), 1);       break;
+        case xxHash("--size"):      option.size = std::max(atoi(value), 1);         break;
+        case xxHash("--threads"):   option.threads = std::max(atoi(value), 0);      break;
+        case xxHash("--seed"):      option.seed = unsigned(strtoul(value, nullptr, 10)); break;
+        case xxHash("--step"):      option.step = std::max(float(atof(value)), 0.0f); break;
+        default:
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+static void Usage(char const* name)
+{
+    printf("Usage : %s [options]\n", name);
+    printf("  --scene <file.xxb>    Load a scene instead of the synthetic field\n");
+    printf("  --output <file.json>  Write the result to a file instead of stdout\n");
+    printf("  --test <name>         Run the tests (all, object, shader, texture, update) and exit\n");
+    printf("  --frames <count>      Measured frames (600)\n");
+    printf("  --warmup <count>      Unmeasured frames before measuring (60)\n");
+    printf("  --groups <count>      Synthetic group count (1000)\n");
+    printf("  --size <count>        Synthetic nodes per group (100)\n");
+    printf("  --threads <count>     Job system threads, 0 for hardware (0)\n");
+    printf("  --seed <value>        Synthetic random seed (1)\n");
+    printf("  --step <seconds>      Fixed time step (0.016667)\n");
+}
+//==============================================================================
+//  Scene
+//==============================================================================
+static float Random(unsigned int& seed)
+{
+    // xorshift32 keeps the synthetic scene identical across platforms
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (seed >> 8) * (1.0f / 16777216.0f);
+}
+//------------------------------------------------------------------------------
+static xxMeshPtr CreateCube()
+{
+    xxMeshPtr mesh = xxMesh::Create(false, 0, 0, 0);
+    if (mesh == nullptr)
+        return nullptr;
+
+    mesh->SetVertexCount(8);
+    int index = 0;
+    for (auto& position : mesh->GetPosition())
+    {
+        position = { index & 1 ? 0.5f : -0.5f, index & 2 ? 0.5f : -0.5f, index & 4 ? 0.5f : -0.5f };
+        index++;
+    }
+
+    static uint16_t const faces[36] =
+    {
+        0, 2, 1, 1, 2, 3,
+        4, 5, 6, 5, 7, 6,
+        0, 1, 4, 1, 5, 4,
+        2, 6, 3, 3, 6, 7,
+        0, 4, 2, 2, 4, 6,
+        1, 3, 5, 3, 7, 5,
+    };
+    mesh->SetIndexCount(36);
+    memcpy(mesh->Index, faces, sizeof(faces));
+    mesh->CalculateBound();
+
+    return mesh;
+}
+//------------------------------------------------------------------------------
+static xxNodePtr CreateField(Option const& option)
+{
+    xxMeshPtr mesh = CreateCube();
+    xxMaterialPtr material = xxMaterial::Create();
+    material->DiffuseColor = xxVector3::WHITE;
+    material->DepthTest = "LessEqual";
+    material->DepthWrite = true;
+    material->Cull = true;
+    material->Scissor = false;
+
+    unsigned int seed = option.seed ? option.seed : 1;
+    int columns = std::max(int(sqrtf(float(option.groups))), 1);
+
+    xxNodePtr root = xxNode::Create();
+    root->Name = "Field";
+    for (int i = 0; i < option.groups; ++i)
+    {
+        float speed = Random(seed) * 2.0f - 1.0f;
+        float phase = Random(seed) * float(M_PI) * 2.0f;
+        xxModifierPtr rotate = InterpolatedQuaternionModifier::Create(KEY_COUNT, [=](size_t index, float& time, xxVector4& quaternion)
+        {
+            float angle = phase + speed * index * 0.1f;
+            time = index / 30.0f;
+            quaternion = { 0.0f, 0.0f, sinf(angle), cosf(angle) };
+        });
+
+        xxNodePtr group = xxNode::Create();
+        group->SetTranslate({ float(i % columns) * 10.0f, float(i / columns) * 10.0f, 0.0f });
+        group->UpdateRotateTranslateScale();
+        group->Modifiers.emplace_back(rotate);
+        root->AttachChild(group);
+        for (int j = 0; j < option.size; ++j)
+        {
+            xxNodePtr node = xxNode::Create();
+            node->SetTranslate({ Random(seed) * 8.0f - 4.0f, Random(seed) * 8.0f - 4.0f, Random(seed) * 2.0f });
+            node->UpdateRotateTranslateScale();
+            node->Mesh = mesh;
+            node->Material = material;
+            group->AttachChild(node);
+        }
+    }
+    return root;
+}
+//------------------------------------------------------------------------------
+static xxCameraPtr CreateCamera(xxNodePtr const& root)
+{
+    xxVector4 const& bound = root->WorldBound;
+    xxVector3 center = { bound.x, bound.y, bound.z };
+    float radius = std::max(bound.w, 1.0f);
+
+    xxCameraPtr camera = xxCamera::Create();
+    camera->Location = center + xxVector3{ -0.5f, -0.5f, 0.5f } * radius;
+    camera->LookAt(center, xxVector3::Z);
+    camera->SetFOV(float(WIDTH) / float(HEIGHT), 60.0f, radius * 4.0f);
+    camera->Update();
+    return camera;
+}
+//==============================================================================
+//  Statistic
+//==============================================================================
+struct Phase
+{
+    char const* name;
+    std::vector<double> samples;
+};
+//------------------------------------------------------------------------------
+static void WritePhase(FILE* file, Phase& phase, bool last)
+{
+    std::vector<double>& samples = phase.samples;
+    std::sort(samples.begin(), samples.end());
+
+    double total = 0.0;
+    for (double sample : samples)
+        total += sample;
+    size_t count = samples.size();
+    double mean = count ? total / count : 0.0;
+    double minimum = count ? samples.front() : 0.0;
+    double maximum = count ? samples.back() : 0.0;
+    double median = count ? samples[count / 2] : 0.0;
+    double p95 = count ? samples[std::min(count - 1, count * 95 / 100)] : 0.0;
+
+    fprintf(file, "    \"%s\": { \"total_ms\": %.4f, \"mean_ms\": %.4f, \"min_ms\": %.4f, \"median_ms\": %.4f, \"p95_ms\": %.4f, \"max_ms\": %.4f }%s\n",
+            phase.name, total, mean, minimum, median, p95, maximum, last ? "" : ",");
+}
+//------------------------------------------------------------------------------
+static std::string Escape(std::string const& text)
+{
+    std::string output;
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':   output += "\\\"";  break;
+        case '\\':  output += "\\\\";  break;
+        case '\n':  output += "\\n";   break;
+        case '\r':  output += "\\r";   break;
+        case '\t':  output += "\\t";   break;
+        default:
+            if (uint8_t(c) < 0x20)
+            {
+                char code[8];
+                snprintf(code, sizeof(code), "\\u%04X", uint8_t(c));
+                output += code;
+                break;
+            }
+            output += c;
+            break;
+        }
+    }
+    return output;
+}
+//==============================================================================
+//  Main
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    Option option;
+    if (ParseOption(option, argc, argv) == false)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    uint64_t instance = xxCreateInstanceNULL();
+    uint64_t device = xxCreateDevice(instance);
+    if (instance == 0 || device == 0)
+    {
+        xxLog(TAG, "NULL backend is not available");
+        xxDestroyDevice(device);
+        xxDestroyInstance(instance);
+        return 1;
+    }
+    uint64_t renderPass = xxCreateRenderPass(device, true, true, true, true, true, true);
+    uint64_t swapchain = xxCreateSwapchain(device, renderPass, nullptr, WIDTH, HEIGHT, 0);
+
+    Runtime::Initialize();
+    if (option.threads)
+    {
+        JobSystem::Initialize(option.threads);
+    }
+
+    if (option.test)
+    {
+        bool succeed = Test(option.test, device);
+        Runtime::Shutdown();
+        xxDestroySwapchain(swapchain);
+        xxDestroyRenderPass(renderPass);
+        xxDestroyDevice(device);
+        xxDestroyInstance(instance);
+        return succeed ? 0 : 1;
+    }
+
+    double begin = 0.0;
+    double end = 0.0;
+    xxGetCurrentTime(&begin);
+    xxNodePtr root = option.scene ? Binary::Load(option.scene) : CreateField(option);
+    xxGetCurrentTime(&end);
+    double loadTime = (end - begin) * 1000.0;
+    if (root == nullptr)
+    {
+        xxLog(TAG, "%s is not found", option.scene ? option.scene : "synthetic");
+        Runtime::Shutdown();
+        xxDestroySwapchain(swapchain);
+        xxDestroyRenderPass(renderPass);
+        xxDestroyDevice(device);
+        xxDestroyInstance(instance);
+        return 1;
+    }
+
+    NodeTools::UpdateNodeFlags(root);
+    root->Update(0.0f);
+    root->UpdateBound();
+
+    size_t nodeCount = 0;
+    size_t meshCount = 0;
+    Node::Traversal(root, [&](xxNodePtr const& node)
+    {
+        nodeCount++;
+        meshCount += node->Mesh ? 1 : 0;
+        return true;
+    });
+
+    std::vector<Node*> updateNodes;
+    for (xxNodePtr const& node : (*root))
+    {
+        updateNodes.push_back(node.get());
+    }
+
+    xxCameraPtr camera = CreateCamera(root);
+    std::vector<Node*> visibleNodes;
+
+    Phase update = { "update" };
+    Phase cull = { "cull" };
+    Phase draw = { "draw" };
+    Phase frame = { "frame" };
+    update.samples.reserve(option.frames);
+    cull.samples.reserve(option.frames);
+    draw.samples.reserve(option.frames);
+    frame.samples.reserve(option.frames);
+
+    size_t visibleCount = 0;
+    float scale = 1.0f;
+    float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    for (int i = 0; i < option.warmup + option.frames; ++i)
+    {
+        float time = i * option.step;
+        double t0 = 0.0;
+        double t1 = 0.0;
+        double t2 = 0.0;
+        double t3 = 0.0;
+
+        xxGetCurrentTime(&t0);
+        NodeTools::Update(updateNodes, time);
+        root->UpdateBound();
+
+        xxGetCurrentTime(&t1);
+        DrawTools::Cull(root, camera, visibleNodes);
+
+        xxGetCurrentTime(&t2);
+        Runtime::Update();
+        uint64_t commandBuffer = xxGetCommandBuffer(device, swapchain);
+        uint64_t framebuffer = xxGetFramebuffer(device, swapchain, &scale);
+        xxBeginCommandBuffer(commandBuffer);
+        uint64_t commandEncoder = xxBeginRenderPass(commandBuffer, framebuffer, renderPass, WIDTH, HEIGHT, clearColor, 1.0f, 0);
+        xxSetViewport(commandEncoder, 0, 0, WIDTH, HEIGHT, 0.0f, 1.0f);
+        xxSetScissor(commandEncoder, 0, 0, WIDTH, HEIGHT);
+
+        DrawTools::DrawData drawData;
+        drawData.device = device;
+        drawData.commandEncoder = commandEncoder;
+        drawData.camera3D = camera;
+        drawData.camera = camera.get();
+        drawData.materialIndex = Material::DEFAULT;
+        DrawTools::Sort(drawData, visibleNodes);
+        DrawTools::Draw(drawData, visibleNodes);
+
+        xxEndRenderPass(commandEncoder, framebuffer, renderPass);
+        xxEndCommandBuffer(commandBuffer);
+        xxSubmitCommandBuffer(commandBuffer, swapchain);
+        xxPresentSwapchain(swapchain);
+        xxGetCurrentTime(&t3);
+
+        if (i < option.warmup)
+            continue;
+        update.samples.push_back((t1 - t0) * 1000.0);
+        cull.samples.push_back((t2 - t1) * 1000.0);
+        draw.samples.push_back((t3 - t2) * 1000.0);
+        frame.samples.push_back((t3 - t0) * 1000.0);
+        visibleCount += visibleNodes.size();
+    }
+
+    FILE* file = option.output ? fopen(option.output, "wb") : stdout;
+    if (file == nullptr)
+    {
+        xxLog(TAG, "%s is not writable", option.output);
+        file = stdout;
+    }
+    fprintf(file, "{\n");
+    fprintf(file, "  \"version\": \"%s\",\n", Runtime::Version);
+    fprintf(file, "  \"compiler\": \"%s\",\n", Runtime::Compiler);
+    fprintf(file, "  \"target\": \"%s\",\n", Runtime::Target);
+    fprintf(file, "  \"backend\": \"%s\",\n", xxGetInstanceName());
+    fprintf(file, "  \"scene\": \"%s\",\n", option.scene ? Escape(xxFile::GetName(option.scene)).c_str() : "synthetic");
+    fprintf(file, "  \"seed\": %u,\n", option.seed);
+    fprintf(file, "  \"step\": %.6f,\n", option.step);
+    fprintf(file, "  \"warmup\": %d,\n", option.warmup);
+    fprintf(file, "  \"frames\": %d,\n", option.frames);
+    fprintf(file, "  \"threads\": %d,\n", JobSystem::ThreadCount());
+    fprintf(file, "  \"nodes\": %zd,\n", nodeCount);
+    fprintf(file, "  \"meshes\": %zd,\n", meshCount);
+    fprintf(file, "  \"visible\": %zd,\n", visibleCount / option.frames);
+    fprintf(file, "  \"load_ms\": %.4f,\n", loadTime);
+    Buffer::ConstantStatistics constant = Buffer::GetConstantStatistics();
+    fprintf(file, "  \"constant\": { \"frame_bytes\": %zd, \"high_water_bytes\": %zd, \"allocations\": %zd, \"buffers\": %zd },\n",
+            constant.frameBytes, constant.highWaterBytes, constant.allocationCount, constant.bufferCount);
+    fprintf(file, "  \"phases\": {\n");
+    WritePhase(file, update, false);
+    WritePhase(file, cull, false);
+    WritePhase(file, draw, false);
+    WritePhase(file, frame, true);
+    fprintf(file, "  }\n");
+    fprintf(file, "}\n");
+    if (file != stdout)
+    {
+        fclose(file);
+    }
+
+    visibleNodes.clear();
+    updateNodes.clear();
+    camera = nullptr;
+    root = nullptr;
+    Runtime::Shutdown();
+
+    xxDestroySwapchain(swapchain);
+    xxDestroyRenderPass(renderPass);
+    xxDestroyDevice(device);
+    xxDestroyInstance(instance);
+
+    return 0;
+}
@@ -7,6 +7,7 @@
 #include "Editor.h"
 #include <Runtime/Graphic/Camera.h>
 #include <Runtime/Graphic/Node.h>
+#include <Runtime/Graphic/Shader.h>
 #include "Event/Event.h"
 #include "Import/Import.h"
 #include "Utility/Tools.h"
@@ -30,6 +31,7 @@ extern "C" void __cxa_pure_virtual(void) {}
 //------------------------------------------------------------------------------
 moduleAPI char const* Create(const CreateData& createData)
 {
+    Shader::CachePath = std::string(xxGetDocumentPath()) + "/.minamoto.shader";
     Runtime::Initialize();
 
     Document::Initialize();
@@ -60,6 +60,7 @@ double ExportEvent::Execute()
         }
         if (ImGui::BeginTabItem("Minamoto"))
         {
+            ImGui::Checkbox("Compress", &compress);
             if (ImGui::Button("Export"))
                 Minamoto();
             ImGui::EndTabItem();
@@ -105,7 +106,7 @@ void ExportEvent::Minamoto()
     });
 
     float begin = xxGetCurrentTime();
-    if (Binary::Save(filename.c_str(), root))
+    if (Binary::Save(filename.c_str(), root, compress))
     {
         xxLog(TAG, "Export : %s (%0.fus)", xxFile::GetName(filename.c_str(), true).c_str(), (xxGetCurrentTime() - begin) * 1000000);
     }
@@ -18,6 +18,7 @@ class ExportEvent : public Event
     std::string name;
 
     bool pathItemWidth = false;
+    bool compress = false;
     IGFD::FileDialog* fileDialog = nullptr;
 
 public:
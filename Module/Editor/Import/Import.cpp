@@ -6,6 +6,7 @@
 //==============================================================================
 #include "Editor.h"
 #include <map>
+#include <unordered_map>
 #include <xxGraphicPlus/xxFile.h>
 #include <xxGraphicPlus/xxTexture.h>
 #include <Runtime/Graphic/Material.h>
@@ -90,20 +91,21 @@ void Import::MergeNode(xxNodePtr const& target, xxNodePtr const& source, xxNodeP
     std::vector<std::pair<xxNodePtr, xxNodePtr>> merge;
     std::vector<xxNodePtr> append;
 
+    // The first child wins when names are duplicated
+    std::unordered_map<std::string, xxNodePtr> children;
+    for (xxNodePtr const& left : (*target))
+    {
+        children.emplace(left->Name, left);
+    }
+
     for (xxNodePtr const& right : (*source))
     {
-        bool found = false;
-        for (xxNodePtr const& left : (*target))
+        auto it = children.find(right->Name);
+        if (it != children.end())
         {
-            if (left->Name == right->Name)
-            {
-                merge.emplace_back(left, right);
-                found = true;
-                break;
-            }
-        }
-        if (found)
+            merge.emplace_back(it->second, right);
             continue;
+        }
 
         append.push_back(right);
     }
@@ -94,7 +94,7 @@ double ImportEvent::Execute()
     if (mipmapTextures.empty() == false)
     {
         auto it = mipmapTextures.begin();
-        TextureTools::MipmapTexture(*it);
+        TextureTools::MipmapTexture(*it, mipmapFilter, mipmapGamma, mipmapCoverage ? 0.5f : 0.0f);
         mipmapTextures.erase(it);
     }
 
@@ -182,6 +182,13 @@ double ImportEvent::Execute()
                 });
                 Statistic();
             }
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(96.0f);
+            ImGui::Combo("##MipmapFilter", &mipmapFilter, "Box\0Kaiser\0Lanczos\0");
+            ImGui::SameLine();
+            ImGui::Checkbox("Gamma", &mipmapGamma);
+            ImGui::SameLine();
+            ImGui::Checkbox("Alpha Coverage", &mipmapCoverage);
             ImGui::EndTable();
         }
     }
@@ -252,7 +259,7 @@ void ImportEvent::ThreadedExecute()
     if (strcasestr(name, ".ply"))
         output = ImportPolygon::Create(name);
     if (strcasestr(name, ".xxb"))
-        output = Binary::Load(name);
+        output = Binary::Load(name, true);
     thiz->output = output;
 
     xxLog("Hierarchy", "Import : %s (%0.fus)", xxFile::GetName(name).c_str(), (xxGetCurrentTime() - begin) * 1000000);
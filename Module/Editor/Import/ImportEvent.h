@@ -27,6 +27,9 @@ class ImportEvent : public Event
     xxNodePtr output;
 
     std::set<xxTexturePtr> mipmapTextures;
+    int mipmapFilter = 0;
+    bool mipmapGamma = false;
+    bool mipmapCoverage = false;
 
     int nodeCount = 0;
     int meshCount = 0;
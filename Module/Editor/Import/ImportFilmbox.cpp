@@ -18,7 +18,7 @@
 #include <Runtime/Modifier/Interpolated/InterpolatedTranslateModifier.h>
 #include <Runtime/Modifier/Interpolated/InterpolatedQuaternion16Modifier.h>
 #include <Runtime/Modifier/Baked/BakedQuaternionModifier.h>
-#include <Runtime/Modifier/Baked/BakedQuaternion16Modifier.h>
+#include <Runtime/Modifier/Baked/BakedQuaternion48Modifier.h>
 #include <Runtime/Tools/NodeTools.h>
 #include "Utility/MeshTools.h"
 #include "ImportFilmbox.h"
@@ -134,7 +134,7 @@ static void CreateAnimation(ufbx_scene* scene, xxNodePtr const& root, Import::Im
                 modifier = QuaternionModifier::Create(quat(reduction_node.rotation_keys[0].value));
                 rotation = 1;
             }
-            else if (Modifier::CalculateSize(Modifier::INTERPOLATED_QUATERNION16, reduction_node.rotation_keys.count) < Modifier::CalculateSize(Modifier::BAKED_QUATERNION16, baked_node.rotation_keys.count))
+            else if (Modifier::CalculateSize(Modifier::INTERPOLATED_QUATERNION16, reduction_node.rotation_keys.count) < Modifier::CalculateSize(Modifier::BAKED_QUATERNION48, baked_node.rotation_keys.count))
             {
                 modifier = InterpolatedQuaternion16Modifier::Create(reduction_node.rotation_keys.count, [&](size_t index, float& time, xxVector4& quaternion)
                 {
@@ -145,7 +145,7 @@ static void CreateAnimation(ufbx_scene* scene, xxNodePtr const& root, Import::Im
             }
             else
             {
-                modifier = BakedQuaternion16Modifier::Create(baked_node.rotation_keys.count, float(baked->playback_duration), [&](size_t index, xxVector4& quaternion)
+                modifier = BakedQuaternion48Modifier::Create(baked_node.rotation_keys.count, float(baked->playback_duration), [&](size_t index, xxVector4& quaternion)
                 {
                     quaternion = quat(baked_node.rotation_keys.data[index].value);
                 });
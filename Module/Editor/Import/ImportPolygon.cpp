@@ -5,206 +5,440 @@
 // https://github.com/NyankoLab/Minamoto
 //==============================================================================
 #include "Editor.h"
+#include <algorithm>
 #include <xxGraphicPlus/xxFile.h>
 #include <Runtime/Graphic/Material.h>
 #include <Runtime/Graphic/Mesh.h>
 #include <Runtime/Graphic/Node.h>
+#include <Runtime/Tools/CSV.h>
 #include "Utility/MeshTools.h"
 #include "ImportPolygon.h"
 
+#define TAG "ImportPolygon"
+
 //==============================================================================
-static void RemoveBreakline(char* text)
+enum PolygonFormat
 {
-    if (char* slash = strrchr(text, '\r'))
-        slash[0] = 0;
-    if (char* slash = strrchr(text, '\n'))
-        slash[0] = 0;
-}
+    ASCII,
+    BINARY_LITTLE_ENDIAN,
+    BINARY_BIG_ENDIAN,
+};
 //------------------------------------------------------------------------------
-static int ToInt(char const* text)
+struct PolygonProperty
 {
-    return text ? atoi(text) : -1;
-}
+    enum Type
+    {
+        NONE,
+        INT8,
+        UINT8,
+        INT16,
+        UINT16,
+        INT32,
+        UINT32,
+        FLOAT32,
+        FLOAT64,
+    };
+    enum Semantic
+    {
+        X, Y, Z,
+        NX, NY, NZ,
+        RED, GREEN, BLUE, ALPHA,
+        U, V,
+        OTHER,
+        INDICES,
+    };
+
+    Type type = NONE;
+    Type countType = NONE;
+    Semantic semantic = OTHER;
+};
 //------------------------------------------------------------------------------
-static float ToFloat(char const* text)
+struct PolygonElement
 {
-    return text ? float(atof(text)) : 0.0f;
-}
+    std::string name;
+    size_t count = 0;
+    std::vector<PolygonProperty> properties;
+};
 //------------------------------------------------------------------------------
-xxNodePtr ImportPolygon::Create(char const* ply)
+struct PolygonReader
 {
-    std::vector<char> attributes;
-    std::vector<xxVector3> vertices;
-    std::vector<uint16_t> faces16;
-    std::vector<uint32_t> faces32;
-    xxNodePtr root;
+    char const* cursor = nullptr;
+    char const* end = nullptr;
+    bool ascii = false;
+    bool swap = false;
+    bool failed = false;
 
-    FILE* file = fopen(ply, "rb");
-    if (file == nullptr)
-        return root;
+    template<class T>
+    double Load()
+    {
+        if (end - cursor < static_cast<ptrdiff_t>(sizeof(T)))
+        {
+            failed = true;
+            cursor = end;
+            return 0.0;
+        }
+        char bytes[sizeof(T)];
+        memcpy(bytes, cursor, sizeof(T));
+        if (swap)
+            std::reverse(bytes, bytes + sizeof(T));
+        cursor += sizeof(T);
+        T value;
+        memcpy(&value, bytes, sizeof(T));
+        return double(value);
+    }
 
-    root = xxNode::Create();
-    root->Name = xxFile::GetName(ply);
-    root->Material = xxMaterial::Create();
-    root->Material->Lighting = true;
-    root->Material->DiffuseColor = xxVector3::WHITE;
-    root->Material->DepthTest = "LessEqual";
-    root->Material->DepthWrite = true;
-    root->Material->Cull = true;
-    root->Material->Scissor = false;
+    double Read(PolygonProperty::Type type)
+    {
+        if (ascii)
+        {
+            while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n'))
+                cursor++;
+            char const* token = cursor;
+            while (cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')
+                cursor++;
+            double value = 0.0;
+            if (CSV::Convert(std::string_view(token, cursor - token), value) == false)
+                failed = true;
+            return value;
+        }
+        switch (type)
+        {
+        case PolygonProperty::INT8:      return Load<int8_t>();
+        case PolygonProperty::UINT8:     return Load<uint8_t>();
+        case PolygonProperty::INT16:     return Load<int16_t>();
+        case PolygonProperty::UINT16:    return Load<uint16_t>();
+        case PolygonProperty::INT32:     return Load<int32_t>();
+        case PolygonProperty::UINT32:    return Load<uint32_t>();
+        case PolygonProperty::FLOAT32:   return Load<float>();
+        case PolygonProperty::FLOAT64:   return Load<double>();
+        default:                         failed = true; return 0.0;
+        }
+    }
 
-    auto finish = [&]()
+    // Every value of a list needs its bytes, or at least one character in ASCII
+    bool Fits(size_t count, size_t size)
+    {
+        if (count <= size_t(end - cursor) / std::max<size_t>(ascii ? 1 : size, 1))
+            return true;
+        failed = true;
+        cursor = end;
+        return false;
+    }
+};
+//------------------------------------------------------------------------------
+static PolygonProperty::Type ToType(std::string const& text)
+{
+    switch (xxHash(text.c_str()))
+    {
+    case xxHash("char"):
+    case xxHash("int8"):    return PolygonProperty::INT8;
+    case xxHash("uchar"):
+    case xxHash("uint8"):   return PolygonProperty::UINT8;
+    case xxHash("short"):
+    case xxHash("int16"):   return PolygonProperty::INT16;
+    case xxHash("ushort"):
+    case xxHash("uint16"):  return PolygonProperty::UINT16;
+    case xxHash("int"):
+    case xxHash("int32"):   return PolygonProperty::INT32;
+    case xxHash("uint"):
+    case xxHash("uint32"):  return PolygonProperty::UINT32;
+    case xxHash("float"):
+    case xxHash("float32"): return PolygonProperty::FLOAT32;
+    case xxHash("double"):
+    case xxHash("float64"): return PolygonProperty::FLOAT64;
+    default:                return PolygonProperty::NONE;
+    }
+}
+//------------------------------------------------------------------------------
+static size_t ToSize(PolygonProperty::Type type)
+{
+    switch (type)
+    {
+    case PolygonProperty::INT8:
+    case PolygonProperty::UINT8:    return 1;
+    case PolygonProperty::INT16:
+    case PolygonProperty::UINT16:   return 2;
+    case PolygonProperty::INT32:
+    case PolygonProperty::UINT32:
+    case PolygonProperty::FLOAT32:  return 4;
+    case PolygonProperty::FLOAT64:  return 8;
+    default:                        return 0;
+    }
+}
+//------------------------------------------------------------------------------
+static PolygonProperty::Semantic ToSemantic(std::string const& element, std::string const& text)
+{
+    switch (xxHash(element.c_str()))
     {
-        if (vertices.empty() == false)
+    case xxHash("vertex"):
+        switch (xxHash(text.c_str()))
         {
-            xxMeshPtr mesh = root->Mesh = xxMesh::Create(false, 0, 0, 0);
-            if (mesh)
-            {
-                mesh->Name = root->Name;
-                if (vertices.size())
-                {
-                    mesh->SetVertexCount(static_cast<int>(vertices.size()));
-                    auto source = vertices.begin();
-                    for (auto& position : mesh->GetPosition())
-                    {
-                        position = (*source++);
-                    }
-                }
-                if (faces16.size())
-                {
-                    mesh->SetIndexCount(static_cast<int>(faces16.size()));
-                    memcpy(mesh->Index, faces16.data(), sizeof(uint16_t) * faces16.size());
-                }
-                else if (faces32.size())
-                {
-                    mesh->SetIndexCount(static_cast<int>(faces32.size()));
-                    memcpy(mesh->Index, faces32.data(), sizeof(uint32_t) * faces32.size());
-                }
-                mesh = root->Mesh = MeshTools::OptimizeMesh(mesh);
-                mesh = root->Mesh = MeshTools::CreateMeshlet(mesh);
-                mesh = root->Mesh = MeshTools::NormalizeMesh(mesh, false);
-                mesh->CalculateBound();
-            }
-            vertices.clear();
+        case xxHash("x"):           return PolygonProperty::X;
+        case xxHash("y"):           return PolygonProperty::Y;
+        case xxHash("z"):           return PolygonProperty::Z;
+        case xxHash("nx"):          return PolygonProperty::NX;
+        case xxHash("ny"):          return PolygonProperty::NY;
+        case xxHash("nz"):          return PolygonProperty::NZ;
+        case xxHash("red"):
+        case xxHash("diffuse_red"): return PolygonProperty::RED;
+        case xxHash("green"):
+        case xxHash("diffuse_green"):
+                                    return PolygonProperty::GREEN;
+        case xxHash("blue"):
+        case xxHash("diffuse_blue"):
+                                    return PolygonProperty::BLUE;
+        case xxHash("alpha"):       return PolygonProperty::ALPHA;
+        case xxHash("u"):
+        case xxHash("s"):
+        case xxHash("texture_u"):
+        case xxHash("texture_s"):   return PolygonProperty::U;
+        case xxHash("v"):
+        case xxHash("t"):
+        case xxHash("texture_v"):
+        case xxHash("texture_t"):   return PolygonProperty::V;
+        default:                    return PolygonProperty::OTHER;
         }
-    };
+    case xxHash("face"):
+        switch (xxHash(text.c_str()))
+        {
+        case xxHash("vertex_indices"):
+        case xxHash("vertex_index"):    return PolygonProperty::INDICES;
+        default:                        return PolygonProperty::OTHER;
+        }
+    default:
+        return PolygonProperty::OTHER;
+    }
+}
+//------------------------------------------------------------------------------
+static float ToColor(PolygonProperty::Type type, double value)
+{
+    switch (type)
+    {
+    case PolygonProperty::UINT8:    return float(value / 255.0);
+    case PolygonProperty::UINT16:   return float(value / 65535.0);
+    default:                        return float(value);
+    }
+}
+//------------------------------------------------------------------------------
+xxNodePtr ImportPolygon::Create(char const* ply)
+{
+    float begin = xxGetCurrentTime();
 
-    size_t faceCount = 0;
-    size_t vertexCount = 0;
+    std::vector<char> buffer;
+    xxFile* file = xxFile::Load(ply);
+    if (file == nullptr)
+        return nullptr;
+    buffer.resize(file->Size());
+    buffer.resize(file->Read(buffer.data(), buffer.size()));
+    delete file;
 
-    char line[256];
-    while (fgets(line, 256, file))
+    // Header
+    std::vector<PolygonElement> elements;
+    PolygonFormat format = ASCII;
+    char const* text = buffer.data();
+    char const* end = text + buffer.size();
+    bool header = false;
+    while (text < end && header == false)
     {
-        RemoveBreakline(line);
+        char const* next = static_cast<char const*>(memchr(text, '\n', end - text));
+        next = next ? next + 1 : end;
 
-        char* lasts = line;
-        char const* statement = strsep(&lasts, " ");
-        if (statement == nullptr)
+        std::vector<std::string> tokens;
+        for (char const* token = text; token < next; )
+        {
+            while (token < next && (*token == ' ' || *token == '\t' || *token == '\r' || *token == '\n'))
+                token++;
+            char const* last = token;
+            while (last < next && *last != ' ' && *last != '\t' && *last != '\r' && *last != '\n')
+                last++;
+            if (token != last)
+                tokens.emplace_back(token, last);
+            token = last;
+        }
+        text = next;
+        if (tokens.empty())
             continue;
 
-        switch (xxHash(statement))
+        switch (xxHash(tokens[0].c_str()))
         {
-        case xxHash("comment"):
         case xxHash("format"):
-        case xxHash("ply"):
-            break;
-        case xxHash("element"):
-        {
-            char const* type = strsep(&lasts, " ");
-            char const* count = strsep(&lasts, " ");
-            if (type == nullptr)
+            if (tokens.size() < 2)
                 break;
-            switch (xxHash(type))
+            switch (xxHash(tokens[1].c_str()))
             {
-            case xxHash("face"):
-                faceCount = ToInt(count);
+            case xxHash("binary_little_endian"):
+                format = BINARY_LITTLE_ENDIAN;
                 break;
-            case xxHash("vertex"):
-                vertexCount = ToInt(count);
+            case xxHash("binary_big_endian"):
+                format = BINARY_BIG_ENDIAN;
                 break;
             default:
+                format = ASCII;
                 break;
             }
             break;
-        }
+        case xxHash("element"):
+            if (tokens.size() < 3)
+                break;
+            elements.push_back({ tokens[1], size_t(strtoull(tokens[2].c_str(), nullptr, 10)) });
+            break;
         case xxHash("property"):
-        {
-            char const* type = strsep(&lasts, " ");
-            char const* attribute = strsep(&lasts, " ");
-            if (type == nullptr || attribute == nullptr)
+            if (elements.empty() || tokens.size() < 3)
                 break;
-            switch (xxHash(type))
+            if (tokens[1] == "list" && tokens.size() >= 5)
             {
-            case xxHash("float"):
-                switch (xxHash(attribute))
-                {
-                case xxHash("x"):
-                    attributes.push_back('x');
-                    break;
-                case xxHash("y"):
-                    attributes.push_back('y');
-                    break;
-                case xxHash("z"):
-                    attributes.push_back('z');
-                    break;
-                default:
-                    attributes.push_back('?');
-                    break;
-                }
-                break;
-            case xxHash("list"):
-                break;
+                PolygonProperty property;
+                property.countType = ToType(tokens[2]);
+                property.type = ToType(tokens[3]);
+                property.semantic = ToSemantic(elements.back().name, tokens[4]);
+                elements.back().properties.push_back(property);
+            }
+            else
+            {
+                PolygonProperty property;
+                property.type = ToType(tokens[1]);
+                property.semantic = ToSemantic(elements.back().name, tokens[2]);
+                if (property.semantic == PolygonProperty::INDICES)
+                    property.semantic = PolygonProperty::OTHER;
+                elements.back().properties.push_back(property);
             }
             break;
-        }
         case xxHash("end_header"):
+            header = true;
+            break;
+        default:
+            break;
+        }
+    }
+    if (header == false)
+    {
+        xxLog(TAG, "Failed to load : %s", ply);
+        return nullptr;
+    }
+
+    // Body
+    uint16_t endian = 1;
+    bool little = reinterpret_cast<char const*>(&endian)[0] == 1;
+    PolygonReader reader;
+    reader.cursor = text;
+    reader.end = end;
+    reader.ascii = (format == ASCII);
+    reader.swap = (format == BINARY_LITTLE_ENDIAN && little == false) || (format == BINARY_BIG_ENDIAN && little == true);
+
+    MeshTools::MeshData data;
+    std::vector<uint32_t> polygon;
+    for (PolygonElement const& element : elements)
+    {
+        bool vertex = (element.name == "vertex");
+        if (vertex)
         {
-            while (fgets(line, 256, file))
+            // Trust the header count only as far as the remaining bytes allow
+            size_t stride = 0;
+            for (PolygonProperty const& property : element.properties)
             {
-                RemoveBreakline(line);
+                stride += reader.ascii ? 1 : ToSize(property.countType != PolygonProperty::NONE ? property.countType : property.type);
+                data.normalCount |= (property.semantic >= PolygonProperty::NX && property.semantic <= PolygonProperty::NZ) ? 1 : 0;
+                data.colorCount |= (property.semantic >= PolygonProperty::RED && property.semantic <= PolygonProperty::ALPHA) ? 1 : 0;
+                data.textureCount |= (property.semantic >= PolygonProperty::U && property.semantic <= PolygonProperty::V) ? 1 : 0;
+            }
+            size_t count = std::min(element.count, size_t(reader.end - reader.cursor) / std::max<size_t>(stride, 1));
+            data.positions.reserve(count);
+            data.normals.reserve(count * data.normalCount);
+            data.colors.reserve(count * data.colorCount);
+            data.textures.reserve(count * data.textureCount);
+        }
 
-                char* lasts = line;
-                if (vertices.size() < vertexCount)
-                {
-                    xxVector3 vertex;
-                    vertex.x = ToFloat(strsep(&lasts, " ")) * -100.0f;
-                    vertex.z = ToFloat(strsep(&lasts, " ")) * 100.0f;
-                    vertex.y = ToFloat(strsep(&lasts, " ")) * -100.0f;
-                    vertices.push_back(vertex);
-                }
-                else if (vertexCount < 65536 && faces16.size() < faceCount * 3)
+        for (size_t i = 0; i < element.count && reader.failed == false; ++i)
+        {
+            float values[PolygonProperty::OTHER] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0 };
+            for (PolygonProperty const& property : element.properties)
+            {
+                if (property.countType != PolygonProperty::NONE)
                 {
-                    size_t count = ToInt(strsep(&lasts, " "));
-                    size_t pos = faces16.size();
-                    for (size_t i = 0; i < count; ++i)
+                    // The prefix comes from the file, the list must fit in the remaining data
+                    double length = reader.Read(property.countType);
+                    size_t count = length >= 0.0 && length <= double(reader.end - reader.cursor) ? size_t(length) : SIZE_MAX;
+                    if (reader.Fits(count, ToSize(property.type)) == false)
+                        break;
+                    if (property.semantic != PolygonProperty::INDICES)
                     {
-                        faces16.insert(faces16.begin() + pos, ToInt(strsep(&lasts, " ")));
+                        for (size_t j = 0; j < count; ++j)
+                            reader.Read(property.type);
+                        continue;
                     }
-                }
-                else if (faces32.size() < faceCount * 3)
-                {
-                    size_t count = ToInt(strsep(&lasts, " "));
-                    size_t pos = faces32.size();
-                    for (size_t i = 0; i < count; ++i)
+
+                    // Reversed Triangle Fan
+                    polygon.resize(count);
+                    for (size_t j = 0; j < count; ++j)
+                        polygon[count - 1 - j] = uint32_t(reader.Read(property.type));
+                    for (size_t j = 2; j < count; ++j)
                     {
-                        faces32.insert(faces32.begin() + pos, ToInt(strsep(&lasts, " ")));
+                        data.indices.push_back(polygon[0]);
+                        data.indices.push_back(polygon[j - 1]);
+                        data.indices.push_back(polygon[j]);
                     }
+                    continue;
+                }
+                double value = reader.Read(property.type);
+                if (property.semantic < PolygonProperty::OTHER)
+                {
+                    values[property.semantic] = (property.semantic >= PolygonProperty::RED && property.semantic <= PolygonProperty::ALPHA) ? ToColor(property.type, value) : float(value);
                 }
             }
-            break;
-        }
-        default:
-            break;
+            if (vertex)
+            {
+                data.positions.push_back(xxVector3{ -values[PolygonProperty::X], -values[PolygonProperty::Z], values[PolygonProperty::Y] } * 100.0f);
+                if (data.normalCount)
+                    data.normals.push_back(Mesh::NormalEncode(xxVector3{ -values[PolygonProperty::NX], -values[PolygonProperty::NZ], values[PolygonProperty::NY] }));
+                if (data.colorCount)
+                    data.colors.push_back(xxVector4{ values[PolygonProperty::RED], values[PolygonProperty::GREEN], values[PolygonProperty::BLUE], values[PolygonProperty::ALPHA] }.ToInteger());
+                if (data.textureCount)
+                    data.textures.push_back(xxVector2{ values[PolygonProperty::U], values[PolygonProperty::V] });
+            }
         }
     }
-    fclose(file);
+    if (reader.failed)
+    {
+        xxLog(TAG, "Truncated : %s", ply);
+    }
+
+    // Drop triangles which reference missing vertices
+    size_t triangleCount = 0;
+    for (size_t i = 0; i + 3 <= data.indices.size(); i += 3)
+    {
+        uint32_t const* triangle = data.indices.data() + i;
+        if (triangle[0] >= data.positions.size() || triangle[1] >= data.positions.size() || triangle[2] >= data.positions.size())
+            continue;
+        memmove(data.indices.data() + triangleCount * 3, triangle, sizeof(uint32_t) * 3);
+        triangleCount++;
+    }
+    data.indices.resize(triangleCount * 3);
+
+    if (data.positions.empty())
+        return nullptr;
 
-    finish();
+    xxNodePtr root = xxNode::Create();
+    root->Name = xxFile::GetName(ply);
+    root->Material = xxMaterial::Create();
+    root->Material->Lighting = true;
+    root->Material->DiffuseColor = xxVector3::WHITE;
+    root->Material->DepthTest = "LessEqual";
+    root->Material->DepthWrite = true;
+    root->Material->Cull = true;
+    root->Material->Scissor = false;
 
-    if (root->GetChildCount() == 0)
+    xxMeshPtr mesh = root->Mesh = MeshTools::CreateMeshFromMeshData(data);
+    mesh->Name = root->Name;
+    if (data.indices.size())
     {
-        return root->Mesh ? root : nullptr;
+        mesh = root->Mesh = MeshTools::OptimizeMesh(mesh);
+        mesh = root->Mesh = MeshTools::CreateMeshlet(mesh);
+        mesh = root->Mesh = MeshTools::NormalizeMesh(mesh, false);
     }
+    mesh->CalculateBound();
+
+    xxLog(TAG, "Create : %s, %zd vertices, %zd triangles (%.0fus)", root->Name.c_str(), data.positions.size(), triangleCount, (xxGetCurrentTime() - begin) * 1000000);
+
     return root;
 }
 //==============================================================================
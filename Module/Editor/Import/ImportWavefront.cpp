@@ -5,11 +5,14 @@
 // https://github.com/NyankoLab/Minamoto
 //==============================================================================
 #include "Editor.h"
+#include <array>
 #include <xxGraphicPlus/xxFile.h>
 #include <xxGraphicPlus/xxTexture.h>
 #include <Runtime/Graphic/Material.h>
 #include <Runtime/Graphic/Mesh.h>
 #include <Runtime/Graphic/Node.h>
+#include <Runtime/Tools/CSV.h>
+#include <Runtime/Tools/JobSystem.h>
 #include "Utility/MeshTools.h"
 #include "ImportWavefront.h"
 
@@ -212,9 +215,9 @@ std::map<std::string, ImportWavefront::WavefrontMaterial> ImportWavefront::Creat
     return materials;
 }
 //------------------------------------------------------------------------------
-xxNodePtr ImportWavefront::Create(char const* obj, std::function<void(xxNodePtr&&)> callback)
+static xxNodePtr CreateLegacy(char const* obj, std::function<void(xxNodePtr&&)> callback)
 {
-    std::map<std::string, WavefrontMaterial> materials;
+    std::map<std::string, ImportWavefront::WavefrontMaterial> materials;
     std::vector<xxVector3> vertices;
     std::vector<xxVector3> normals;
     std::vector<xxVector2> textures;
@@ -222,7 +225,7 @@ xxNodePtr ImportWavefront::Create(char const* obj, std::function<void(xxNodePtr&
     std::vector<xxVector3> faceNormals;
     std::vector<xxVector2> faceTextures;
     std::string name;
-    WavefrontMaterial* material = nullptr;
+    ImportWavefront::WavefrontMaterial* material = nullptr;
     xxNodePtr root;
 
     FILE* file = fopen(obj, "rb");
@@ -237,7 +240,7 @@ xxNodePtr ImportWavefront::Create(char const* obj, std::function<void(xxNodePtr&
         if (faceVertices.empty())
             return;
         xxNodePtr child = xxNode::Create();
-        child->Name = CheckDuplicateName(root, name);
+        child->Name = Import::CheckDuplicateName(root, name);
         child->Mesh = MeshTools::CreateMesh(faceVertices, {}, {}, faceNormals, {}, faceTextures, {});
         if (child->Mesh)
         {
@@ -279,7 +282,7 @@ xxNodePtr ImportWavefront::Create(char const* obj, std::function<void(xxNodePtr&
         switch (xxHash(statement))
         {
         case xxHash("mtllib"):
-            materials.merge(CreateMaterial(GeneratePath(obj, lasts).c_str()));
+            materials.merge(ImportWavefront::CreateMaterial(GeneratePath(obj, lasts).c_str()));
             break;
         case xxHash("v"):
             finish();
@@ -409,3 +412,527 @@ xxNodePtr ImportWavefront::Create(char const* obj, std::function<void(xxNodePtr&
     return root;
 }
 //==============================================================================
+//  Parser
+//==============================================================================
+struct WavefrontChunk
+{
+    enum Type { BREAK, GROUP, LIBRARY, MATERIAL, OBJECT };
+    struct Statement
+    {
+        Type type;
+        std::string_view argument;
+        size_t corner;
+    };
+
+    char const* begin = nullptr;
+    char const* end = nullptr;
+    size_t vertexBase = 0;
+    size_t normalBase = 0;
+    size_t textureBase = 0;
+
+    std::vector<xxVector3> vertices;
+    std::vector<xxVector3> normals;
+    std::vector<xxVector2> textures;
+    std::vector<std::array<uint32_t, 3>> corners;   // vertex, texture, normal
+    std::vector<uint32_t> relatives;                // corner * 3 + attribute of negative indices
+    std::vector<Statement> statements;
+};
+//------------------------------------------------------------------------------
+struct WavefrontGroup
+{
+    struct Span
+    {
+        WavefrontChunk const* chunk;
+        size_t begin;
+        size_t end;
+    };
+
+    std::string name;
+    ImportWavefront::WavefrontMaterial* material = nullptr;
+    std::vector<Span> spans;
+    size_t cornerCount = 0;
+    size_t unknownCount = 0;
+    MeshTools::MeshData data;
+};
+//------------------------------------------------------------------------------
+static char const* SkipSpace(char const* text, char const* end)
+{
+    while (text < end && (*text == ' ' || *text == '\t'))
+        text++;
+    return text;
+}
+//------------------------------------------------------------------------------
+static char const* SkipToken(char const* text, char const* end)
+{
+    while (text < end && *text != ' ' && *text != '\t')
+        text++;
+    return text;
+}
+//------------------------------------------------------------------------------
+static float ParseFloat(char const*& text, char const* end)
+{
+    char const* token = SkipSpace(text, end);
+    text = SkipToken(token, end);
+    float value = 0.0f;
+    CSV::Convert(std::string_view(token, text - token), value);
+    return value;
+}
+//------------------------------------------------------------------------------
+static uint32_t ParseIndex(char const*& text, char const* end, size_t count, int& relative)
+{
+    bool negative = (text < end && *text == '-');
+    if (negative)
+        text++;
+    uint32_t value = 0;
+    bool number = false;
+    for (; text < end && unsigned(*text - '0') < 10; ++text)
+    {
+        value = value * 10 + (*text - '0');
+        number = true;
+    }
+    if (number == false || value == 0)
+        return UINT32_MAX;
+
+    // Negative indices count back from the end of the chunk, the chunk base is added later
+    relative = negative;
+    return negative ? uint32_t(count) - value : value - 1;
+}
+//------------------------------------------------------------------------------
+static void ParseChunk(WavefrontChunk& chunk)
+{
+    std::array<uint32_t, 3> polygon[3];
+    int polygonRelative[3] = {};
+    bool face = true;
+
+    char const* end = chunk.end;
+    for (char const* line = chunk.begin; line < end; )
+    {
+        char const* next = static_cast<char const*>(memchr(line, '\n', end - line));
+        next = next ? next : end;
+        char const* last = next;
+        while (last > line && (last[-1] == '\r' || last[-1] == ' ' || last[-1] == '\t'))
+            last--;
+        line = SkipSpace(line, last);
+
+        char const* token = SkipToken(line, last);
+        std::string_view statement(line, token - line);
+        char const* text = SkipSpace(token, last);
+        line = next + 1;
+
+        if (statement.empty() || statement[0] == '#')
+            continue;
+
+        if (statement == "v")
+        {
+            // A vertex after faces starts a new mesh
+            if (face)
+            {
+                chunk.statements.push_back({ WavefrontChunk::BREAK, {}, chunk.corners.size() });
+                face = false;
+            }
+            xxVector3& vertex = chunk.vertices.emplace_back();
+            vertex.x = ParseFloat(text, last);
+            vertex.z = ParseFloat(text, last);
+            vertex.y = -ParseFloat(text, last);
+        }
+        else if (statement == "vn")
+        {
+            xxVector3& normal = chunk.normals.emplace_back();
+            normal.x = ParseFloat(text, last);
+            normal.z = ParseFloat(text, last);
+            normal.y = -ParseFloat(text, last);
+        }
+        else if (statement == "vt")
+        {
+            xxVector2& texture = chunk.textures.emplace_back();
+            texture.x = 0 + ParseFloat(text, last);
+            texture.y = 1 - ParseFloat(text, last);
+        }
+        else if (statement == "f")
+        {
+            face = true;
+
+            // Triangle Fan
+            for (size_t i = 0; text < last; ++i)
+            {
+                std::array<uint32_t, 3> corner = { UINT32_MAX, UINT32_MAX, UINT32_MAX };
+                std::array<int, 3> relative = {};
+                corner[0] = ParseIndex(text, last, chunk.vertices.size(), relative[0]);
+                if (text < last && *text == '/')
+                {
+                    text++;
+                    corner[1] = ParseIndex(text, last, chunk.textures.size(), relative[1]);
+                    if (text < last && *text == '/')
+                    {
+                        text++;
+                        corner[2] = ParseIndex(text, last, chunk.normals.size(), relative[2]);
+                    }
+                }
+                text = SkipSpace(SkipToken(text, last), last);
+
+                size_t slot = std::min<size_t>(i, 2);
+                polygon[slot] = corner;
+                polygonRelative[slot] = relative[0] | (relative[1] << 1) | (relative[2] << 2);
+                if (i >= 2)
+                {
+                    for (size_t j = 0; j < 3; ++j)
+                    {
+                        for (size_t k = 0; k < 3; ++k)
+                        {
+                            if (polygonRelative[j] & (1 << k))
+                                chunk.relatives.push_back(uint32_t((chunk.corners.size() + j) * 3 + k));
+                        }
+                    }
+                    chunk.corners.insert(chunk.corners.end(), polygon, polygon + 3);
+                    polygon[1] = polygon[2];
+                    polygonRelative[1] = polygonRelative[2];
+                }
+            }
+        }
+        else if (statement == "g")
+        {
+            chunk.statements.push_back({ WavefrontChunk::GROUP, std::string_view(text, last - text), chunk.corners.size() });
+        }
+        else if (statement == "mtllib")
+        {
+            chunk.statements.push_back({ WavefrontChunk::LIBRARY, std::string_view(text, last - text), chunk.corners.size() });
+        }
+        else if (statement == "o")
+        {
+            chunk.statements.push_back({ WavefrontChunk::OBJECT, std::string_view(text, last - text), chunk.corners.size() });
+        }
+        else if (statement == "usemtl")
+        {
+            chunk.statements.push_back({ WavefrontChunk::MATERIAL, std::string_view(text, last - text), chunk.corners.size() });
+        }
+    }
+}
+//------------------------------------------------------------------------------
+static void BuildGroup(WavefrontGroup& group, std::vector<xxVector3> const& vertices, std::vector<xxVector3> const& normals, std::vector<xxVector2> const& textures)
+{
+    MeshTools::MeshData& data = group.data;
+    data.indices.reserve(group.cornerCount);
+
+    // Open addressing from the vertex / texture / normal tuple to the output vertex
+    auto hash = [](std::array<uint32_t, 3> const& key)
+    {
+        uint32_t hash = key[0] * 0x9E3779B1u ^ key[1] * 0x85EBCA77u ^ key[2] * 0xC2B2AE3Du;
+        hash ^= hash >> 16;
+        hash *= 0x7FEB352Du;
+        hash ^= hash >> 15;
+        return hash;
+    };
+    size_t capacity = 16;
+    while (capacity < std::min(group.cornerCount, vertices.size()) * 2)
+        capacity *= 2;
+    std::vector<uint32_t> table(capacity, UINT32_MAX);
+    std::vector<std::array<uint32_t, 3>> keys;
+    keys.reserve(capacity / 2);
+
+    bool hasNormal = false;
+    bool hasTexture = false;
+    uint32_t zeroNormal = Mesh::NormalEncode(xxVector3::ZERO);
+    for (WavefrontGroup::Span const& span : group.spans)
+    {
+        auto const* corners = span.chunk->corners.data();
+        for (size_t i = span.begin; i + 3 <= span.end; i += 3)
+        {
+            auto const* triangle = corners + i;
+            if (triangle[0][0] >= vertices.size() || triangle[1][0] >= vertices.size() || triangle[2][0] >= vertices.size())
+            {
+                group.unknownCount++;
+                continue;
+            }
+            for (size_t j = 0; j < 3; ++j)
+            {
+                std::array<uint32_t, 3> key = triangle[j];
+                if (key[1] >= textures.size())
+                    key[1] = UINT32_MAX;
+                if (key[2] >= normals.size())
+                    key[2] = UINT32_MAX;
+
+                size_t slot = hash(key) & (capacity - 1);
+                while (table[slot] != UINT32_MAX && keys[table[slot]] != key)
+                    slot = (slot + 1) & (capacity - 1);
+
+                if (table[slot] == UINT32_MAX)
+                {
+                    if (keys.size() * 2 >= capacity)
+                    {
+                        capacity *= 2;
+                        table.assign(capacity, UINT32_MAX);
+                        for (uint32_t k = 0; k < keys.size(); ++k)
+                        {
+                            size_t rehash = hash(keys[k]) & (capacity - 1);
+                            while (table[rehash] != UINT32_MAX)
+                                rehash = (rehash + 1) & (capacity - 1);
+                            table[rehash] = k;
+                        }
+                        slot = hash(key) & (capacity - 1);
+                        while (table[slot] != UINT32_MAX)
+                            slot = (slot + 1) & (capacity - 1);
+                    }
+                    table[slot] = uint32_t(keys.size());
+                    keys.push_back(key);
+                    data.positions.push_back(vertices[key[0]]);
+                    data.normals.push_back(key[2] != UINT32_MAX ? Mesh::NormalEncode(normals[key[2]]) : zeroNormal);
+                    data.textures.push_back(key[1] != UINT32_MAX ? textures[key[1]] : xxVector2::ZERO);
+                    hasNormal |= (key[2] != UINT32_MAX);
+                    hasTexture |= (key[1] != UINT32_MAX);
+                }
+                data.indices.push_back(table[slot]);
+            }
+        }
+    }
+
+    data.normalCount = hasNormal ? 1 : 0;
+    data.textureCount = hasTexture ? 1 : 0;
+    if (hasNormal == false)
+        data.normals = std::vector<uint32_t>();
+    if (hasTexture == false)
+        data.textures = std::vector<xxVector2>();
+}
+//------------------------------------------------------------------------------
+xxNodePtr ImportWavefront::Create(char const* obj, std::function<void(xxNodePtr&&)> callback)
+{
+    float begin = xxGetCurrentTime();
+
+    std::vector<char> buffer;
+    if (CSV::Read(obj, buffer) == false)
+        return nullptr;
+
+    xxNodePtr root = xxNode::Create();
+    root->Name = xxFile::GetName(obj);
+
+    // Line-aligned chunks
+    size_t const chunkSize = 1024 * 1024;
+    std::vector<WavefrontChunk> chunks;
+    char const* text = buffer.data();
+    char const* end = text + buffer.size();
+    while (text < end)
+    {
+        char const* next = text + std::min<size_t>(chunkSize, end - text);
+        next = static_cast<char const*>(memchr(next, '\n', end - next));
+        next = next ? next + 1 : end;
+        WavefrontChunk& chunk = chunks.emplace_back();
+        chunk.begin = text;
+        chunk.end = next;
+        text = next;
+    }
+    JobSystem::ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            ParseChunk(chunks[i]);
+    });
+
+    // Indices are global across the file
+    size_t vertexCount = 0;
+    size_t normalCount = 0;
+    size_t textureCount = 0;
+    for (WavefrontChunk& chunk : chunks)
+    {
+        chunk.vertexBase = vertexCount;
+        chunk.normalBase = normalCount;
+        chunk.textureBase = textureCount;
+        vertexCount += chunk.vertices.size();
+        normalCount += chunk.normals.size();
+        textureCount += chunk.textures.size();
+    }
+    std::vector<xxVector3> vertices(vertexCount);
+    std::vector<xxVector3> normals(normalCount);
+    std::vector<xxVector2> textures(textureCount);
+    JobSystem::ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            WavefrontChunk& chunk = chunks[i];
+            std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + chunk.vertexBase);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalBase);
+            std::copy(chunk.textures.begin(), chunk.textures.end(), textures.begin() + chunk.textureBase);
+            chunk.vertices = std::vector<xxVector3>();
+            chunk.normals = std::vector<xxVector3>();
+            chunk.textures = std::vector<xxVector2>();
+
+            size_t const bases[3] = { chunk.vertexBase, chunk.textureBase, chunk.normalBase };
+            for (uint32_t relative : chunk.relatives)
+            {
+                chunk.corners[relative / 3][relative % 3] += uint32_t(bases[relative % 3]);
+            }
+        }
+    });
+
+    // Statements
+    std::map<std::string, WavefrontMaterial> materials;
+    std::vector<WavefrontGroup> groups;
+    WavefrontGroup group;
+    auto finish = [&]()
+    {
+        if (group.cornerCount == 0)
+            return;
+        std::string name = group.name;
+        groups.push_back(std::move(group));
+        group = {};
+        group.name = name;
+    };
+    auto append = [&](WavefrontChunk const& chunk, size_t begin, size_t end)
+    {
+        if (begin == end)
+            return;
+        group.spans.push_back({ &chunk, begin, end });
+        group.cornerCount += end - begin;
+    };
+    for (WavefrontChunk const& chunk : chunks)
+    {
+        size_t corner = 0;
+        for (WavefrontChunk::Statement const& statement : chunk.statements)
+        {
+            append(chunk, corner, statement.corner);
+            corner = statement.corner;
+
+            std::string argument(statement.argument);
+            switch (statement.type)
+            {
+            case WavefrontChunk::BREAK:
+                finish();
+                break;
+            case WavefrontChunk::GROUP:
+                finish();
+
+                xxLog("ImportWavefront", "Create Group : %s", argument.c_str());
+                group.name = argument;
+                break;
+            case WavefrontChunk::LIBRARY:
+                materials.merge(CreateMaterial(GeneratePath(obj, argument.c_str()).c_str()));
+                break;
+            case WavefrontChunk::MATERIAL:
+                finish();
+
+                xxLog("ImportWavefront", "Use Material : %s", argument.c_str());
+                group.material = &materials[argument];
+                break;
+            case WavefrontChunk::OBJECT:
+                finish();
+
+                xxLog("ImportWavefront", "Create Object : %s", argument.c_str());
+                group.name = argument;
+                break;
+            }
+        }
+        append(chunk, corner, chunk.corners.size());
+    }
+    finish();
+
+    // Meshes
+    JobSystem::ParallelFor(groups.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            BuildGroup(groups[i], vertices, normals, textures);
+    });
+    for (WavefrontGroup& output : groups)
+    {
+        if (output.unknownCount)
+        {
+            xxLog("ImportWavefront", "Unknown vertice : %zd triangles in %s", output.unknownCount, output.name.c_str());
+        }
+        if (output.data.positions.empty())
+            continue;
+
+        xxNodePtr child = xxNode::Create();
+        child->Name = CheckDuplicateName(root, output.name);
+        child->Mesh = MeshTools::CreateMeshFromMeshData(output.data);
+        child->Mesh->Name = child->Name;
+        output.data = {};
+        if (output.material)
+        {
+            child->Material = output.material->output;
+            if (output.material->bump)
+            {
+                child->Mesh = MeshTools::NormalizeMesh(child->Mesh, true);
+            }
+        }
+        if (callback)
+        {
+            callback(std::move(child));
+        }
+        else
+        {
+            root->AttachChild(child);
+        }
+    }
+
+    xxLog("ImportWavefront", "Create : %s, %zd vertices, %zd chunks (%.0fus)", root->Name.c_str(), vertexCount, chunks.size(), (xxGetCurrentTime() - begin) * 1000000);
+
+    if (root->GetChildCount() == 0)
+    {
+        return root->Mesh ? root : nullptr;
+    }
+    return root;
+}
+//------------------------------------------------------------------------------
+void ImportWavefront::Benchmark()
+{
+    std::string path = std::string(xxGetDocumentPath()) + "/Benchmark.obj";
+
+    // 1024 x 1024 quads on a height field
+    int const size = 1024;
+    std::string text;
+    text.reserve(size_t(size + 1) * (size + 1) * 64 + size_t(size) * size * 64);
+    char line[128];
+    for (int y = 0; y <= size; ++y)
+    {
+        for (int x = 0; x <= size; ++x)
+        {
+            float u = float(x) / size;
+            float v = float(y) / size;
+            text.append(line, snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", u * 100.0f, sinf(u * 10.0f) * cosf(v * 10.0f), v * 100.0f));
+            text.append(line, snprintf(line, sizeof(line), "vt %.6f %.6f\n", u, v));
+        }
+    }
+    text.append("vn 0 1 0\n");
+    text.append("g Benchmark\n");
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            int a = y * (size + 1) + x + 1;
+            int b = a + 1;
+            int c = a + size + 2;
+            int d = a + size + 1;
+            text.append(line, snprintf(line, sizeof(line), "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, b, b, c, c, d, d));
+        }
+    }
+    xxFile* file = xxFile::Save(path.c_str());
+    if (file == nullptr)
+        return;
+    file->Write(text.data(), text.size());
+    delete file;
+    text = std::string();
+
+    float begin = xxGetCurrentTime();
+    xxNodePtr legacy = CreateLegacy(path.c_str(), nullptr);
+    float legacyTime = xxGetCurrentTime() - begin;
+
+    begin = xxGetCurrentTime();
+    xxNodePtr current = Create(path.c_str());
+    float currentTime = xxGetCurrentTime() - begin;
+
+    remove(path.c_str());
+
+    // The legacy path is unindexed, compare every corner
+    bool match = false;
+    xxMeshPtr legacyMesh = legacy && legacy->GetChildCount() ? legacy->GetChild(0)->Mesh : nullptr;
+    xxMeshPtr currentMesh = current && current->GetChildCount() ? current->GetChild(0)->Mesh : nullptr;
+    if (legacyMesh && currentMesh)
+    {
+        MeshTools::MeshData legacyData = MeshTools::CreateMeshDataFromMesh(legacyMesh);
+        MeshTools::MeshData currentData = MeshTools::CreateMeshDataFromMesh(currentMesh);
+        match = currentData.indices.size() == legacyData.positions.size();
+        for (size_t i = 0; match && i < currentData.indices.size(); ++i)
+        {
+            match = legacyData.positions[i] == currentData.positions[currentData.indices[i]];
+        }
+    }
+
+    xxLog("ImportWavefront", "Benchmark : %d triangles, legacy %.0fus, current %.0fus, x%.1f, %s", size * size * 2, legacyTime * 1000000, currentTime * 1000000, legacyTime / currentTime, match ? "Match" : "Mismatch");
+}
+//==============================================================================
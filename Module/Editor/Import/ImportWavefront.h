@@ -27,4 +27,6 @@ struct ImportWavefront : public Import
 public:
     static std::map<std::string, WavefrontMaterial> CreateMaterial(char const* mtl);
     static xxNodePtr Create(char const* obj, std::function<void(xxNodePtr&&)> callback = nullptr);
+
+    static void Benchmark();
 };
@@ -5,6 +5,7 @@
 // https://github.com/NyankoLab/Minamoto
 //==============================================================================
 #include "Editor.h"
+#include <unordered_map>
 #include <Runtime/Graphic/Mesh.h>
 #include <Runtime/Graphic/Node.h>
 #include <meshoptimizer/src/meshoptimizer.h>
@@ -311,19 +312,8 @@ xxMeshPtr MeshTools::CreateMeshlet(xxMeshPtr const& mesh)
     return mesh;
 }
 //------------------------------------------------------------------------------
-xxMeshPtr MeshTools::IndexingMesh(xxMeshPtr const& mesh)
+static void IndexingMeshLinear(MeshTools::MeshData& data)
 {
-    if (mesh == nullptr)
-        return nullptr;
-    if (mesh->Index)
-        return mesh;
-
-    float begin = xxGetCurrentTime();
-
-    MeshData data = CreateMeshDataFromMesh(mesh);
-    if (data.positions.empty())
-        return mesh;
-
     data.indices.clear();
     for (uint32_t i = 0; i < data.positions.size(); ++i)
     {
@@ -379,11 +369,154 @@ xxMeshPtr MeshTools::IndexingMesh(xxMeshPtr const& mesh)
             --j;
         }
     }
+}
+//------------------------------------------------------------------------------
+static void RemapMeshData(MeshTools::MeshData& data, std::vector<uint32_t> const& remap, size_t count)
+{
+    auto compact = [&](auto& container, int c)
+    {
+        if (c == 0 || container.size() < remap.size() * c)
+            return;
+        std::remove_reference_t<decltype(container)> output(count * c);
+        for (size_t i = remap.size(); i > 0; --i)
+        {
+            // Backward so the first vertex of each group is the one kept
+            for (int j = 0; j < c; ++j)
+                output[remap[i - 1] * c + j] = container[(i - 1) * c + j];
+        }
+        container.swap(output);
+    };
+
+    compact(data.positions, 1);
+    compact(data.boneWeights, data.skinning ? 1 : 0);
+    compact(data.boneIndices, data.skinning ? 1 : 0);
+    compact(data.normals, data.normalCount);
+    compact(data.colors, data.colorCount);
+    compact(data.textures, data.textureCount);
+
+    if (data.indices.empty())
+    {
+        data.indices = remap;
+    }
+    else
+    {
+        for (uint32_t& index : data.indices)
+            index = remap[index];
+    }
+}
+//------------------------------------------------------------------------------
+size_t MeshTools::WeldVertex(MeshData const& data, std::vector<uint32_t>& remap, float epsilon)
+{
+    size_t count = data.positions.size();
+    int skinning = data.skinning ? 1 : 0;
+    int stride = 3 + skinning * 4 + data.normalCount + data.colorCount + data.textureCount * 2;
+    float scale = epsilon > 0.0f ? 1.0f / epsilon : 0.0f;
+
+    auto exact = [](float value) -> uint32_t
+    {
+        uint32_t bits = 0;
+        if (value != 0.0f)
+            memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    };
+    auto quantize = [&](float value) -> uint32_t
+    {
+        if (scale == 0.0f)
+            return exact(value);
+        return uint32_t(int32_t(floorf(value * scale + 0.5f)));
+    };
+
+    // Flatten every attribute into a fixed-width key per vertex
+    std::vector<uint32_t> keys(count * stride);
+    uint32_t* key = keys.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        xxVector3 const& position = data.positions[i];
+        (*key++) = quantize(position.x);
+        (*key++) = quantize(position.y);
+        (*key++) = quantize(position.z);
+        if (skinning)
+        {
+            xxVector3 const& boneWeight = data.boneWeights[i];
+            (*key++) = exact(boneWeight.x);
+            (*key++) = exact(boneWeight.y);
+            (*key++) = exact(boneWeight.z);
+            (*key++) = data.boneIndices[i];
+        }
+        for (int j = 0; j < data.normalCount; ++j)
+            (*key++) = data.normals[i * data.normalCount + j];
+        for (int j = 0; j < data.colorCount; ++j)
+            (*key++) = data.colors[i * data.colorCount + j];
+        for (int j = 0; j < data.textureCount; ++j)
+        {
+            xxVector2 const& texture = data.textures[i * data.textureCount + j];
+            (*key++) = quantize(texture.x);
+            (*key++) = quantize(texture.y);
+        }
+    }
+
+    // Open addressing with linear probing
+    size_t capacity = 16;
+    while (capacity < count * 2)
+        capacity *= 2;
+    std::vector<uint32_t> table(capacity, UINT32_MAX);
+
+    size_t unique = 0;
+    remap.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t const* key = &keys[i * stride];
+        uint32_t hash = 2166136261u;
+        for (int j = 0; j < stride; ++j)
+            hash = (hash ^ key[j]) * 16777619u;
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6Bu;
+        hash ^= hash >> 13;
+
+        size_t slot = hash & (capacity - 1);
+        while (true)
+        {
+            uint32_t index = table[slot];
+            if (index == UINT32_MAX)
+            {
+                table[slot] = uint32_t(i);
+                remap[i] = uint32_t(unique++);
+                break;
+            }
+            if (memcmp(&keys[index * stride], key, stride * sizeof(uint32_t)) == 0)
+            {
+                remap[i] = remap[index];
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+    }
+
+    return unique;
+}
+//------------------------------------------------------------------------------
+xxMeshPtr MeshTools::IndexingMesh(xxMeshPtr const& mesh, float epsilon)
+{
+    if (mesh == nullptr)
+        return nullptr;
+    if (mesh->Index)
+        return mesh;
+
+    float begin = xxGetCurrentTime();
+
+    MeshData data = CreateMeshDataFromMesh(mesh);
+    if (data.positions.empty())
+        return mesh;
+
+    std::vector<uint32_t> remap;
+    size_t count = WeldVertex(data, remap, epsilon);
+    data.indices.clear();
+    RemapMeshData(data, remap, count);
 
     xxMeshPtr output = CreateMeshFromMeshData(data);
     output->Name = mesh->Name;
 
-    xxLog(TAG, "OptimizeMesh : %s Vertex count from %d to %d and index count %d (%.0fus)", mesh->Name.c_str(), mesh->Count[xxMesh::VERTEX], output->Count[xxMesh::VERTEX], output->Count[xxMesh::INDEX], (xxGetCurrentTime() - begin) * 1000000);
+    xxLog(TAG, "IndexingMesh : %s Vertex count from %d to %d and index count %d (%.0fus)", mesh->Name.c_str(), mesh->Count[xxMesh::VERTEX], output->Count[xxMesh::VERTEX], output->Count[xxMesh::INDEX], (xxGetCurrentTime() - begin) * 1000000);
 
     return output;
 }
@@ -571,20 +704,66 @@ xxMeshPtr MeshTools::ResetMesh(xxMeshPtr const& mesh, xxVector3& origin)
 //------------------------------------------------------------------------------
 void MeshTools::UnifyMesh(xxNodePtr const& node, float threshold)
 {
+    float begin = xxGetCurrentTime();
+
+    // The signature is invariant under the four rotations around Z tried below.
+    // Each term moves by at most 2 * threshold between equal meshes, so a cell
+    // of that size keeps every equal pair within the neighbouring cells.
+    float cell = std::max(threshold * 2.0f, FLT_EPSILON);
+    auto signature = [cell](xxMeshPtr const& mesh)
+    {
+        float height = 0.0f;
+        float radius = 0.0f;
+        for (xxVector3 const& position : mesh->GetPosition())
+        {
+            height += position.z;
+            radius += sqrtf(position.x * position.x + position.y * position.y);
+        }
+        float count = float(std::max(mesh->VertexCount, 1));
+        return std::pair<int64_t, int64_t>(int64_t(floorf(height / count / cell)), int64_t(floorf(radius / count / cell)));
+    };
+    auto hash = [](int vertexCount, int64_t height, int64_t radius)
+    {
+        uint64_t value = uint64_t(vertexCount);
+        value = value * 0x9E3779B97F4A7C15ull + uint64_t(height);
+        value = value * 0x9E3779B97F4A7C15ull + uint64_t(radius);
+        return value;
+    };
+
     std::vector<xxMeshPtr> meshes;
+    std::unordered_map<xxMesh*, size_t> indices;
+    std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+    std::vector<size_t> candidates;
+    size_t unified = 0;
     Node::Traversal(node, [&](xxNodePtr const& node)
     {
         if (node->Mesh == nullptr)
             return true;
+        if (indices.find(node->Mesh.get()) != indices.end())
+            return true;
 
         float begin = xxGetCurrentTime();
 
         auto left = node->Mesh->GetPosition();
         int vertexCount = node->Mesh->VertexCount;
-        for (xxMeshPtr const& mesh : meshes)
+        auto [height, radius] = signature(node->Mesh);
+
+        candidates.clear();
+        for (int64_t y = -1; y <= 1; ++y)
         {
-            if (node->Mesh == mesh)
-                break;
+            for (int64_t x = -1; x <= 1; ++x)
+            {
+                auto it = buckets.find(hash(vertexCount, height + y, radius + x));
+                if (it != buckets.end())
+                    candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (size_t candidate : candidates)
+        {
+            xxMeshPtr const& mesh = meshes[candidate];
             if (vertexCount != mesh->VertexCount)
                 continue;
             auto right = mesh->GetPosition();
@@ -627,11 +806,82 @@ void MeshTools::UnifyMesh(xxNodePtr const& node, float threshold)
                     { xxVector4::Y, -xxVector4::X, xxVector4::Z, xxVector4::W },
                 };
                 node->LocalMatrix = node->LocalMatrix * rotateMatrix[i];
-                break;
+                node->Flags |= Node::UPDATE_DIRTY;
+                unified++;
+                return true;
             }
         }
+
+        indices[node->Mesh.get()] = meshes.size();
+        buckets[hash(vertexCount, height, radius)].push_back(meshes.size());
         meshes.push_back(node->Mesh);
         return true;
     });
+
+    xxLog(TAG, "UnifyMesh : %zd meshes, %zd unified (%.0fus)", meshes.size(), unified, (xxGetCurrentTime() - begin) * 1000000);
+}
+//------------------------------------------------------------------------------
+void MeshTools::BenchmarkIndexing()
+{
+    for (int size : { 16, 32, 64, 256, 512 })
+    {
+        // Unindexed grid with a normal and a texture coordinate per corner
+        MeshData data;
+        data.normalCount = 1;
+        data.textureCount = 1;
+        uint32_t normal = Mesh::NormalEncode(xxVector3::Z);
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                static int const corners[6][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 0, 1 }, { 1, 0 }, { 1, 1 } };
+                for (auto const& corner : corners)
+                {
+                    float u = float(x + corner[0]) / size;
+                    float v = float(y + corner[1]) / size;
+                    data.positions.push_back({ u * 100.0f, v * 100.0f, sinf(u * 10.0f) * cosf(v * 10.0f) });
+                    data.normals.push_back(normal);
+                    data.textures.push_back({ u, v });
+                }
+            }
+        }
+        size_t count = data.positions.size();
+
+        float linearTime = 0.0f;
+        MeshData linear = data;
+        if (count <= 24576)
+        {
+            float begin = xxGetCurrentTime();
+            IndexingMeshLinear(linear);
+            linearTime = xxGetCurrentTime() - begin;
+        }
+
+        float begin = xxGetCurrentTime();
+        MeshData hashed = data;
+        std::vector<uint32_t> remap;
+        size_t unique = WeldVertex(hashed, remap, 0.0f);
+        RemapMeshData(hashed, remap, unique);
+        float hashedTime = xxGetCurrentTime() - begin;
+
+        bool match = true;
+        if (linearTime != 0.0f)
+        {
+            match = linear.positions.size() == hashed.positions.size() && linear.indices.size() == hashed.indices.size();
+            for (size_t i = 0; match && i < hashed.indices.size(); ++i)
+            {
+                match = linear.positions[linear.indices[i]] == hashed.positions[hashed.indices[i]] &&
+                        linear.textures[linear.indices[i]] == hashed.textures[hashed.indices[i]];
+            }
+        }
+
+        if (linearTime != 0.0f)
+        {
+            xxLog(TAG, "BenchmarkIndexing : %zd to %zd vertices, linear %.0fus, hashed %.0fus, x%.1f, %s", count, unique, linearTime * 1000000, hashedTime * 1000000, linearTime / hashedTime, match ? "Match" : "Mismatch");
+        }
+        else
+        {
+            xxLog(TAG, "BenchmarkIndexing : %zd to %zd vertices, hashed %.0fus", count, unique, hashedTime * 1000000);
+        }
+    }
 }
 //==============================================================================
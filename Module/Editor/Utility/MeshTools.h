@@ -38,9 +38,12 @@ struct MeshTools
                                 std::vector<xxVector2> const& textures,
                                 std::vector<uint32_t> const& indices);
     static xxMeshPtr CreateMeshlet(xxMeshPtr const& mesh);
-    static xxMeshPtr IndexingMesh(xxMeshPtr const& mesh);
+    static xxMeshPtr IndexingMesh(xxMeshPtr const& mesh, float epsilon = 0.0f);
     static xxMeshPtr NormalizeMesh(xxMeshPtr const& mesh, bool tangent);
     static xxMeshPtr OptimizeMesh(xxMeshPtr const& mesh);
     static xxMeshPtr ResetMesh(xxMeshPtr const& mesh, xxVector3& origin);
     static void UnifyMesh(xxNodePtr const& node, float threshold);
+    static size_t WeldVertex(MeshData const& data, std::vector<uint32_t>& remap, float epsilon = 0.0f);
+
+    static void BenchmarkIndexing();
 };
@@ -9,6 +9,7 @@
 #include <Runtime/Graphic/Material.h>
 #include <Runtime/Graphic/Node.h>
 #include <Runtime/Graphic/Texture.h>
+#include <Runtime/Tools/JobSystem.h>
 #include "TextureTools.h"
 
 #define TAG "TextureTools"
@@ -46,96 +47,515 @@ static void stb__CompressAlphaBlockEx(unsigned char* dest, unsigned char* src, i
     }
 }
 
-//==============================================================================
-void TextureTools::CompressTexture(xxTexturePtr const& texture, uint64_t format, std::string const& root, std::string const& subfolder)
+static int const BC_WEIGHT4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+//------------------------------------------------------------------------------
+template<int N>
+static void FitEndpoints(float const (&pixels)[16][N], float (&e0)[N], float (&e1)[N])
 {
-    if (texture->Format != "RGBA8888"_CC)
+    // Principal axis by power iteration
+    float mean[N] = {};
+    float minimum[N];
+    float maximum[N];
+    for (int c = 0; c < N; ++c)
+    {
+        minimum[c] = maximum[c] = pixels[0][c];
+        for (int i = 0; i < 16; ++i)
+        {
+            mean[c] += pixels[i][c] / 16.0f;
+            minimum[c] = std::min(minimum[c], pixels[i][c]);
+            maximum[c] = std::max(maximum[c], pixels[i][c]);
+        }
+    }
+    float covariance[N][N] = {};
+    for (int i = 0; i < 16; ++i)
+        for (int a = 0; a < N; ++a)
+            for (int b = 0; b < N; ++b)
+                covariance[a][b] += (pixels[i][a] - mean[a]) * (pixels[i][b] - mean[b]);
+    float axis[N];
+    for (int c = 0; c < N; ++c)
+        axis[c] = maximum[c] - minimum[c];
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[N] = {};
+        float length = 0.0f;
+        for (int a = 0; a < N; ++a)
+        {
+            for (int b = 0; b < N; ++b)
+                next[a] += covariance[a][b] * axis[b];
+            length = std::max(length, fabsf(next[a]));
+        }
+        if (length == 0.0f)
+            break;
+        for (int c = 0; c < N; ++c)
+            axis[c] = next[c] / length;
+    }
+    float length = 0.0f;
+    for (int c = 0; c < N; ++c)
+        length += axis[c] * axis[c];
+    if (length == 0.0f)
+    {
+        for (int c = 0; c < N; ++c)
+            e0[c] = e1[c] = mean[c];
         return;
+    }
+
+    float low = FLT_MAX;
+    float high = -FLT_MAX;
+    for (int i = 0; i < 16; ++i)
+    {
+        float t = 0.0f;
+        for (int c = 0; c < N; ++c)
+            t += (pixels[i][c] - mean[c]) * axis[c];
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+    for (int c = 0; c < N; ++c)
+    {
+        e0[c] = mean[c] + axis[c] * low / length;
+        e1[c] = mean[c] + axis[c] * high / length;
+    }
+}
+//------------------------------------------------------------------------------
+template<int N>
+static void RefineEndpoints(float const (&pixels)[16][N], int const (&indices)[16], float (&e0)[N], float (&e1)[N])
+{
+    // Least squares with the interpolation weights of the chosen indices
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    float ax[N] = {};
+    float bx[N] = {};
+    for (int i = 0; i < 16; ++i)
+    {
+        float b = BC_WEIGHT4[indices[i]] / 64.0f;
+        float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < N; ++c)
+        {
+            ax[c] += a * pixels[i][c];
+            bx[c] += b * pixels[i][c];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    if (fabsf(determinant) < 1.0e-6f)
+        return;
+    for (int c = 0; c < N; ++c)
+    {
+        e0[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+        e1[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+    }
+}
+//------------------------------------------------------------------------------
+static void PutBits(unsigned char* dest, int& position, uint32_t value, int bits)
+{
+    for (int i = 0; i < bits; ++i, ++position)
+    {
+        if (value & (1 << i))
+            dest[position / 8] |= (1 << (position % 8));
+    }
+}
+//------------------------------------------------------------------------------
+static void CompressBC7Block(unsigned char* dest, unsigned char* block)
+{
+    // Mode 6 : one subset, RGBA 7.7.7.7 with a p-bit per endpoint, 4-bit indices
+    float pixels[16][4];
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 4; ++c)
+            pixels[i][c] = block[i * 4 + c];
+
+    int bestEndpoints[2][4] = {};
+    int bestIndices[16] = {};
+    float bestError = FLT_MAX;
+
+    float e[2][4];
+    FitEndpoints(pixels, e[0], e[1]);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        // Quantize with the p-bit that fits each endpoint best
+        int endpoints[2][4];
+        for (int j = 0; j < 2; ++j)
+        {
+            float error[2] = {};
+            int quantize[2][4];
+            for (int p = 0; p < 2; ++p)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    int q = std::clamp(int(roundf((e[j][c] - p) / 2.0f)), 0, 127);
+                    quantize[p][c] = (q << 1) | p;
+                    float d = quantize[p][c] - e[j][c];
+                    error[p] += d * d;
+                }
+            }
+            int p = error[1] < error[0] ? 1 : 0;
+            for (int c = 0; c < 4; ++c)
+                endpoints[j][c] = quantize[p][c];
+        }
+
+        int palette[16][4];
+        for (int k = 0; k < 16; ++k)
+            for (int c = 0; c < 4; ++c)
+                palette[k][c] = ((64 - BC_WEIGHT4[k]) * endpoints[0][c] + BC_WEIGHT4[k] * endpoints[1][c] + 32) >> 6;
+
+        int indices[16];
+        float error = 0.0f;
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = INT_MAX;
+            for (int k = 0; k < 16; ++k)
+            {
+                int d = 0;
+                for (int c = 0; c < 4; ++c)
+                    d += (palette[k][c] - block[i * 4 + c]) * (palette[k][c] - block[i * 4 + c]);
+                if (d < best)
+                {
+                    best = d;
+                    indices[i] = k;
+                }
+            }
+            error += best;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+            memcpy(bestIndices, indices, sizeof(indices));
+        }
+        RefineEndpoints(pixels, indices, e[0], e[1]);
+    }
+
+    // Anchor index must have a zero high bit
+    if (bestIndices[0] & 8)
+    {
+        for (int c = 0; c < 4; ++c)
+            std::swap(bestEndpoints[0][c], bestEndpoints[1][c]);
+        for (int i = 0; i < 16; ++i)
+            bestIndices[i] = 15 - bestIndices[i];
+    }
+
+    memset(dest, 0, 16);
+    int position = 0;
+    PutBits(dest, position, 1 << 6, 7);
+    for (int c = 0; c < 4; ++c)
+    {
+        PutBits(dest, position, bestEndpoints[0][c] >> 1, 7);
+        PutBits(dest, position, bestEndpoints[1][c] >> 1, 7);
+    }
+    PutBits(dest, position, bestEndpoints[0][0] & 1, 1);
+    PutBits(dest, position, bestEndpoints[1][0] & 1, 1);
+    for (int i = 0; i < 16; ++i)
+        PutBits(dest, position, bestIndices[i], i ? 4 : 3);
+}
+//------------------------------------------------------------------------------
+static uint16_t FloatToHalf(float value)
+{
+    uint16_t sign = 0;
+    if (value < 0.0f)
+    {
+        sign = 0x8000;
+        value = -value;
+    }
+    if (value == 0.0f || value != value)
+        return sign;
+    if (value >= 65504.0f)
+        return sign | 0x7BFF;
+    if (value < 6.103515625e-05f)
+        return sign | uint16_t(roundf(value * 16777216.0f));
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t exponent = ((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    uint32_t half = (exponent << 10) | (mantissa >> 13);
+    half += (mantissa >> 12) & 1;
+    return sign | uint16_t(std::min<uint32_t>(half, 0x7BFF));
+}
+//------------------------------------------------------------------------------
+static float HalfToFloat(uint16_t value)
+{
+    int exponent = (value >> 10) & 0x1F;
+    int mantissa = value & 0x3FF;
+    float result = exponent ? ldexpf(1.0f + mantissa / 1024.0f, exponent - 15) : mantissa / 16777216.0f;
+    return (value & 0x8000) ? -result : result;
+}
+//------------------------------------------------------------------------------
+static void FetchHDR(float (&output)[3], void const* input, uint64_t format)
+{
+    switch (format)
+    {
+    case "RGBA16F"_CC:
+    {
+        uint16_t const* pixel = (uint16_t const*)input;
+        for (int c = 0; c < 3; ++c)
+            output[c] = HalfToFloat(pixel[c]);
+        break;
+    }
+    case "RGBA32F"_CC:
+        memcpy(output, input, sizeof(float) * 3);
+        break;
+    default:
+    {
+        unsigned char const* pixel = (unsigned char const*)input;
+        for (int c = 0; c < 3; ++c)
+            output[c] = pixel[c] / 255.0f;
+        break;
+    }
+    }
+}
+//------------------------------------------------------------------------------
+static void CompressBC6HBlock(unsigned char* dest, float const (&block)[16][3])
+{
+    // Mode 11 : one region, 10-bit endpoints, 4-bit indices, signed as DDSReader maps BC6H to SF16
+    // Endpoints are fitted on the half bit patterns, negative values are clamped to zero
+    float pixels[16][3];
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c)
+            pixels[i][c] = FloatToHalf(std::max(block[i][c], 0.0f));
+
+    auto unquantize = [](int value)
+    {
+        if (value == 0)
+            return 0;
+        if (value >= 511)
+            return 0x7FFF;
+        return ((value << 15) + 0x4000) >> 9;
+    };
+
+    int bestEndpoints[2][3] = {};
+    int bestIndices[16] = {};
+    float bestError = FLT_MAX;
+
+    float e[2][3];
+    FitEndpoints(pixels, e[0], e[1]);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        int endpoints[2][3];
+        int unquantized[2][3];
+        for (int j = 0; j < 2; ++j)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                endpoints[j][c] = std::clamp(int(roundf((e[j][c] - 31.0f) / 62.0f)), 0, 511);
+                unquantized[j][c] = unquantize(endpoints[j][c]);
+            }
+        }
+
+        float palette[16][3];
+        for (int k = 0; k < 16; ++k)
+            for (int c = 0; c < 3; ++c)
+                palette[k][c] = float(((((64 - BC_WEIGHT4[k]) * unquantized[0][c] + BC_WEIGHT4[k] * unquantized[1][c] + 32) >> 6) * 31) >> 5);
+
+        int indices[16];
+        float error = 0.0f;
+        for (int i = 0; i < 16; ++i)
+        {
+            float best = FLT_MAX;
+            for (int k = 0; k < 16; ++k)
+            {
+                float d = 0.0f;
+                for (int c = 0; c < 3; ++c)
+                    d += (palette[k][c] - pixels[i][c]) * (palette[k][c] - pixels[i][c]);
+                if (d < best)
+                {
+                    best = d;
+                    indices[i] = k;
+                }
+            }
+            error += best;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+            memcpy(bestIndices, indices, sizeof(indices));
+        }
+        RefineEndpoints(pixels, indices, e[0], e[1]);
+    }
+
+    if (bestIndices[0] & 8)
+    {
+        for (int c = 0; c < 3; ++c)
+            std::swap(bestEndpoints[0][c], bestEndpoints[1][c]);
+        for (int i = 0; i < 16; ++i)
+            bestIndices[i] = 15 - bestIndices[i];
+    }
+
+    memset(dest, 0, 16);
+    int position = 0;
+    PutBits(dest, position, 0x03, 5);
+    for (int j = 0; j < 2; ++j)
+        for (int c = 0; c < 3; ++c)
+            PutBits(dest, position, bestEndpoints[j][c], 10);
+    for (int i = 0; i < 16; ++i)
+        PutBits(dest, position, bestIndices[i], i ? 4 : 3);
+}
+//------------------------------------------------------------------------------
+static int BlockSize(uint64_t format)
+{
     switch (format)
     {
     case "BC1"_cc:  case "DXT1"_cc:
-    case "BC2"_cc:  case "DXT3"_cc:
-    case "BC3"_cc:  case "DXT5"_cc:
     case "BC4U"_cc: case "ATI1"_cc:
-    case "BC5U"_cc: case "ATI2"_cc:
+        return 8;
+    }
+    return 16;
+}
+//------------------------------------------------------------------------------
+static void CompressBlock(unsigned char* line, unsigned char* source, uint64_t format)
+{
+    switch (format)
+    {
+    case "BC1"_cc:
+    case "DXT1"_cc:
+        stb__CompressColorBlockEx(line, source, STB_DXT_HIGHQUAL);
+        break;
+    case "BC2"_cc:
+    case "DXT3"_cc:
+        stb__ReduceAlphaBlock(line, source + 3, 4);
+        stb__CompressColorBlockEx(line + 8, source, STB_DXT_HIGHQUAL);
+        break;
+    case "BC3"_cc:
+    case "DXT5"_cc:
+        stb__CompressAlphaBlockEx(line, source + 3, 4);
+        stb__CompressColorBlockEx(line + 8, source, STB_DXT_HIGHQUAL);
+        break;
+    case "BC4U"_cc:
+    case "ATI1"_cc:
+        stb__CompressAlphaBlockEx(line, source, 4);
+        break;
+    case "BC5U"_cc:
+    case "ATI2"_cc:
+        stb__CompressAlphaBlockEx(line, source, 4);
+        stb__CompressAlphaBlockEx(line + 8, source + 1, 4);
+        break;
+    case "BC7"_cc:
+        CompressBC7Block(line, source);
         break;
-    default:
-        return;
     }
-    xxTexturePtr uncompressed = xxTexture::Create();
-    uncompressed->Name = texture->Name;
-    uncompressed->Path = texture->Path;
-    xxTexture::Reader(uncompressed);
-    if ((*uncompressed)() == nullptr)
-        return;
-    xxTexturePtr compressed = xxTexture::Create(format, uncompressed->Width, uncompressed->Height, uncompressed->Depth, uncompressed->Mipmap, uncompressed->Array);
+}
+//------------------------------------------------------------------------------
+static void CompressImage(xxTexturePtr const& uncompressed, xxTexturePtr const& compressed, uint64_t format)
+{
+    // One job per row of blocks over every array, mipmap and depth slice
+    struct Row { int array; int mipmap; int depth; int height; };
+    std::vector<Row> rows;
     for (int array = 0; array < uncompressed->Array; ++array)
     {
         for (int mipmap = 0; mipmap < uncompressed->Mipmap; ++mipmap)
         {
-            int levelWidth = (uncompressed->Width >> mipmap);
-            int levelHeight = (uncompressed->Height >> mipmap);
-            int levelDepth = (uncompressed->Depth >> mipmap);
-            if (levelWidth == 0)
-                levelWidth = 1;
-            if (levelHeight == 0)
-                levelHeight = 1;
-            if (levelDepth == 0)
-                levelDepth = 1;
-
-            void* line = (*compressed)(0, 0, 0, mipmap, array);
+            int levelHeight = std::max(uncompressed->Height >> mipmap, 1);
+            int levelDepth = std::max(uncompressed->Depth >> mipmap, 1);
             for (int depth = 0; depth < levelDepth; ++depth)
             {
                 for (int height = 0; height < levelHeight; height += 4)
                 {
-                    for (int width = 0; width < levelWidth; width += 4)
+                    rows.push_back({ array, mipmap, depth, height });
+                }
+            }
+        }
+    }
+
+    int blockSize = BlockSize(format);
+    auto compress = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Row const& row = rows[i];
+            int levelWidth = std::max(uncompressed->Width >> row.mipmap, 1);
+            int levelHeight = std::max(uncompressed->Height >> row.mipmap, 1);
+            int blockWidth = (levelWidth + 3) / 4;
+            int blockHeight = (levelHeight + 3) / 4;
+
+            unsigned char* line = (unsigned char*)(*compressed)(0, 0, 0, row.mipmap, row.array);
+            line += size_t(row.depth * blockHeight + row.height / 4) * blockWidth * blockSize;
+            for (int width = 0; width < levelWidth; width += 4)
+            {
+                void const* texels[16];
+                for (int y = 0; y < 4; ++y)
+                {
+                    for (int x = 0; x < 4; ++x)
                     {
-                        unsigned char source[4 * 4 * 4];
-                        for (int y = 0; y < 4; ++y)
-                        {
-                            for (int x = 0; x < 4; ++x)
-                            {
-                                int offsetX = std::min(width + x, levelWidth - 1);
-                                int offsetY = std::min(height + y, levelHeight - 1);
-                                memcpy(source + y * 4 * 4 + x * 4, (*uncompressed)(offsetX, offsetY, depth, mipmap, array), 4);
-                            }
-                        }
-                        switch (format)
-                        {
-                        case "BC1"_cc:
-                        case "DXT1"_cc:
-                            stb__CompressColorBlockEx((unsigned char*)line, source, STB_DXT_HIGHQUAL);
-                            line = (char*)line + 8;
-                            break;
-                        case "BC2"_cc:
-                        case "DXT3"_cc:
-                            stb__ReduceAlphaBlock((unsigned char*)line, source + 3, 4);
-                            stb__CompressColorBlockEx((unsigned char*)line + 8, source, STB_DXT_HIGHQUAL);
-                            line = (char*)line + 16;
-                            break;
-                        case "BC3"_cc:
-                        case "DXT5"_cc:
-                            stb__CompressAlphaBlockEx((unsigned char*)line, source + 3, 4);
-                            stb__CompressColorBlockEx((unsigned char*)line + 8, source, STB_DXT_HIGHQUAL);
-                            line = (char*)line + 16;
-                            break;
-                        case "BC4U"_cc:
-                        case "ATI1"_cc:
-                            stb__CompressAlphaBlockEx((unsigned char*)line, source, 4);
-                            line = (char*)line + 8;
-                            break;
-                        case "BC5U"_cc:
-                        case "ATI2"_cc:
-                            stb__CompressAlphaBlockEx((unsigned char*)line, source, 4);
-                            stb__CompressAlphaBlockEx((unsigned char*)line + 8, source + 1, 4);
-                            line = (char*)line + 16;
-                            break;
-                        }
+                        int offsetX = std::min(width + x, levelWidth - 1);
+                        int offsetY = std::min(row.height + y, levelHeight - 1);
+                        texels[y * 4 + x] = (*uncompressed)(offsetX, offsetY, row.depth, row.mipmap, row.array);
                     }
                 }
+                if (format == "BC6H"_cc)
+                {
+                    float source[16][3];
+                    for (int i = 0; i < 16; ++i)
+                        FetchHDR(source[i], texels[i], uncompressed->Format);
+                    CompressBC6HBlock(line, source);
+                }
+                else
+                {
+                    unsigned char source[4 * 4 * 4];
+                    for (int i = 0; i < 16; ++i)
+                        memcpy(source + i * 4, texels[i], 4);
+                    CompressBlock(line, source, format);
+                }
+                line += blockSize;
             }
         }
+    };
+
+    // stb_dxt builds its tables on the first block
+    if (rows.empty())
+        return;
+    compress(0, 1);
+    JobSystem::ParallelFor(rows.size() - 1, 4, [&](size_t begin, size_t end)
+    {
+        compress(begin + 1, end + 1);
+    });
+}
+//==============================================================================
+static bool CompressSource(uint64_t source, uint64_t format)
+{
+    // BC6H also takes half and float sources, the others only 8-bit
+    switch (source)
+    {
+    case "RGBA8888"_CC:
+        return true;
+    case "RGBA16F"_CC:
+    case "RGBA32F"_CC:
+        return format == "BC6H"_cc;
     }
+    return false;
+}
+//------------------------------------------------------------------------------
+bool TextureTools::CompressSupported(uint64_t source)
+{
+    return CompressSource(source, "BC6H"_cc);
+}
+//------------------------------------------------------------------------------
+void TextureTools::CompressTexture(xxTexturePtr const& texture, uint64_t format, std::string const& root, std::string const& subfolder)
+{
+    if (CompressSource(texture->Format, format) == false)
+        return;
+    switch (format)
+    {
+    case "BC1"_cc:  case "DXT1"_cc:
+    case "BC2"_cc:  case "DXT3"_cc:
+    case "BC3"_cc:  case "DXT5"_cc:
+    case "BC4U"_cc: case "ATI1"_cc:
+    case "BC5U"_cc: case "ATI2"_cc:
+    case "BC6H"_cc:
+    case "BC7"_cc:
+        break;
+    default:
+        return;
+    }
+    xxTexturePtr uncompressed = xxTexture::Create();
+    uncompressed->Name = texture->Name;
+    uncompressed->Path = texture->Path;
+    xxTexture::Reader(uncompressed);
+    if ((*uncompressed)() == nullptr || CompressSource(uncompressed->Format, format) == false)
+        return;
+    float begin = xxGetCurrentTime();
+    xxTexturePtr compressed = xxTexture::Create(format, uncompressed->Width, uncompressed->Height, uncompressed->Depth, uncompressed->Mipmap, uncompressed->Array);
+    CompressImage(uncompressed, compressed, format);
+    xxLog(TAG, "CompressTexture : %s (%.0fus)", uncompressed->Name.c_str(), (xxGetCurrentTime() - begin) * 1000000);
     std::string ext = ".unknown";
     switch (format)
     {
@@ -144,18 +564,289 @@ void TextureTools::CompressTexture(xxTexturePtr const& texture, uint64_t format,
     case "BC3"_cc:  case "DXT5"_cc: ext = ".bc3";   break;
     case "BC4U"_cc: case "ATI1"_cc: ext = ".bc4u";  break;
     case "BC5U"_cc: case "ATI2"_cc: ext = ".bc5u";  break;
+    case "BC6H"_cc:                 ext = ".bc6h";  break;
+    case "BC7"_cc:                  ext = ".bc7";   break;
     }
     Texture::DDSWriter(compressed, root + subfolder + uncompressed->Name + ext);
 }
 //------------------------------------------------------------------------------
-void TextureTools::MipmapTexture(xxTexturePtr const& texture)
+void TextureTools::BenchmarkCompress(xxTexturePtr const& texture)
+{
+    if (CompressSupported(texture->Format) == false)
+        return;
+    xxTexturePtr uncompressed = xxTexture::Create();
+    uncompressed->Name = texture->Name;
+    uncompressed->Path = texture->Path;
+    xxTexture::Reader(uncompressed);
+    if ((*uncompressed)() == nullptr || CompressSupported(uncompressed->Format) == false)
+        return;
+
+    double pixels = 0.0;
+    for (int mipmap = 0; mipmap < uncompressed->Mipmap; ++mipmap)
+    {
+        int levelWidth = std::max(uncompressed->Width >> mipmap, 1);
+        int levelHeight = std::max(uncompressed->Height >> mipmap, 1);
+        int levelDepth = std::max(uncompressed->Depth >> mipmap, 1);
+        pixels += double(levelWidth) * levelHeight * levelDepth * uncompressed->Array;
+    }
+
+    int threadCount = JobSystem::ThreadCount();
+    for (uint64_t format : { "BC1"_cc, "BC3"_cc, "BC4U"_cc, "BC5U"_cc, "BC6H"_cc, "BC7"_cc })
+    {
+        if (CompressSource(uncompressed->Format, format) == false)
+            continue;
+        xxTexturePtr compressed = xxTexture::Create(format, uncompressed->Width, uncompressed->Height, uncompressed->Depth, uncompressed->Mipmap, uncompressed->Array);
+        for (int threads : { 1, 2, 4, 8 })
+        {
+            JobSystem::Initialize(threads);
+            float begin = xxGetCurrentTime();
+            CompressImage(uncompressed, compressed, format);
+            float elapsed = xxGetCurrentTime() - begin;
+            xxLog(TAG, "BenchmarkCompress : %s %.4s x%d %.2fMP/s (%.0fus)", uncompressed->Name.c_str(), (char*)&format, threads, pixels / 1000000 / elapsed, elapsed * 1000000);
+        }
+    }
+    JobSystem::Initialize(threadCount);
+}
+//------------------------------------------------------------------------------
+static v4sf Saturate(v4sf value)
+{
+    for (int i = 0; i < 4; ++i)
+        value[i] = std::clamp(value[i], 0.0f, 1.0f);
+    return value;
+}
+//------------------------------------------------------------------------------
+static float SRGBToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+}
+//------------------------------------------------------------------------------
+static float LinearToSRGB(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+}
+//------------------------------------------------------------------------------
+static void DecodeRow(v4sf* output, void const* input, int width, uint64_t format, bool gamma)
+{
+    static float const* const decodeSRGB = []()
+    {
+        static float table[256];
+        for (int i = 0; i < 256; ++i)
+            table[i] = SRGBToLinear(i / 255.0f);
+        return table;
+    }();
+
+    switch (format)
+    {
+    case "RGBA8888"_CC:
+    case "BGRA8888"_CC:
+    {
+        unsigned char const* pixel = (unsigned char const*)input;
+        for (int x = 0; x < width; ++x, pixel += 4)
+        {
+            if (gamma)
+                output[x] = v4sf{ decodeSRGB[pixel[0]], decodeSRGB[pixel[1]], decodeSRGB[pixel[2]], pixel[3] / 255.0f };
+            else
+                output[x] = __builtin_convertvector((v4si{ pixel[0], pixel[1], pixel[2], pixel[3] }), v4sf) * (1.0f / 255.0f);
+        }
+        break;
+    }
+    case "RGB10A2"_CC:
+    {
+        uint32_t const* pixel = (uint32_t const*)input;
+        for (int x = 0; x < width; ++x)
+        {
+            v4si value = v4si{ int(pixel[x]), int(pixel[x]), int(pixel[x]), int(pixel[x]) } >> v4si{ 0, 10, 20, 30 } & v4si{ 0x3FF, 0x3FF, 0x3FF, 0x3 };
+            output[x] = __builtin_convertvector(value, v4sf) * v4sf{ 1.0f / 1023.0f, 1.0f / 1023.0f, 1.0f / 1023.0f, 1.0f / 3.0f };
+        }
+        break;
+    }
+    case "R16F"_CC:
+    {
+        uint16_t const* pixel = (uint16_t const*)input;
+        for (int x = 0; x < width; ++x)
+            output[x] = v4sf{ HalfToFloat(pixel[x]), 0.0f, 0.0f, 1.0f };
+        break;
+    }
+    case "RGBA32F"_CC:
+        memcpy(output, input, sizeof(v4sf) * width);
+        break;
+    }
+}
+//------------------------------------------------------------------------------
+static void EncodeRow(void* output, v4sf const* input, int width, uint64_t format, bool gamma)
+{
+    static unsigned char const* const encodeSRGB = []()
+    {
+        static unsigned char table[4096];
+        for (int i = 0; i < 4096; ++i)
+            table[i] = (unsigned char)(LinearToSRGB(i / 4095.0f) * 255.0f + 0.5f);
+        return table;
+    }();
+
+    switch (format)
+    {
+    case "RGBA8888"_CC:
+    case "BGRA8888"_CC:
+    {
+        unsigned char* pixel = (unsigned char*)output;
+        for (int x = 0; x < width; ++x, pixel += 4)
+        {
+            v4sf value = Saturate(input[x]);
+            if (gamma)
+            {
+                v4si index = __builtin_convertvector(value * 4095.0f + 0.5f, v4si);
+                pixel[0] = encodeSRGB[index[0]];
+                pixel[1] = encodeSRGB[index[1]];
+                pixel[2] = encodeSRGB[index[2]];
+                pixel[3] = (unsigned char)(value[3] * 255.0f + 0.5f);
+                continue;
+            }
+            v4si value8 = __builtin_convertvector(value * 255.0f + 0.5f, v4si);
+            pixel[0] = (unsigned char)value8[0];
+            pixel[1] = (unsigned char)value8[1];
+            pixel[2] = (unsigned char)value8[2];
+            pixel[3] = (unsigned char)value8[3];
+        }
+        break;
+    }
+    case "RGB10A2"_CC:
+    {
+        uint32_t* pixel = (uint32_t*)output;
+        for (int x = 0; x < width; ++x)
+        {
+            v4sf value = Saturate(input[x]);
+            v4si bits = __builtin_convertvector(value * v4sf{ 1023.0f, 1023.0f, 1023.0f, 3.0f } + 0.5f, v4si) << v4si{ 0, 10, 20, 30 };
+            pixel[x] = bits[0] | bits[1] | bits[2] | bits[3];
+        }
+        break;
+    }
+    case "R16F"_CC:
+    {
+        uint16_t* pixel = (uint16_t*)output;
+        for (int x = 0; x < width; ++x)
+            pixel[x] = FloatToHalf(input[x][0]);
+        break;
+    }
+    case "RGBA32F"_CC:
+        memcpy(output, input, sizeof(v4sf) * width);
+        break;
+    }
+}
+//------------------------------------------------------------------------------
+static float BesselI0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 16; ++k)
+    {
+        term *= (x / (2.0f * k)) * (x / (2.0f * k));
+        sum += term;
+    }
+    return sum;
+}
+//------------------------------------------------------------------------------
+static float Sinc(float x)
+{
+    if (fabsf(x) < 1.0e-4f)
+        return 1.0f;
+    x *= float(M_PI);
+    return sinf(x) / x;
+}
+//------------------------------------------------------------------------------
+static float Kernel(int filter, float x)
+{
+    x = fabsf(x);
+    switch (filter)
+    {
+    default:
+    case TextureTools::MIPMAP_BOX:
+        return x < 0.5f ? 1.0f : 0.0f;
+    case TextureTools::MIPMAP_KAISER:
+        if (x >= 3.0f)
+            return 0.0f;
+        return Sinc(x) * BesselI0(4.0f * sqrtf(1.0f - (x / 3.0f) * (x / 3.0f))) / BesselI0(4.0f);
+    case TextureTools::MIPMAP_LANCZOS:
+        if (x >= 3.0f)
+            return 0.0f;
+        return Sinc(x) * Sinc(x / 3.0f);
+    }
+}
+//------------------------------------------------------------------------------
+struct MipmapWeights
+{
+    std::vector<int> first;
+    std::vector<int> count;
+    std::vector<int> offset;
+    std::vector<float> weights;
+};
+//------------------------------------------------------------------------------
+static MipmapWeights BuildWeights(int filter, int source, int target)
+{
+    // Kernel is evaluated in target texels, taps are clamped to the edge
+    float scale = float(source) / float(target);
+    float radius = (filter == TextureTools::MIPMAP_BOX ? 0.5f : 3.0f) * scale;
+
+    MipmapWeights output;
+    for (int i = 0; i < target; ++i)
+    {
+        float center = (i + 0.5f) * scale;
+        int begin = int(floorf(center - radius));
+        int end = int(ceilf(center + radius));
+        std::vector<float> weights(source);
+        float total = 0.0f;
+        for (int s = begin; s <= end; ++s)
+        {
+            float weight = Kernel(filter, (s + 0.5f - center) / scale);
+            if (weight == 0.0f)
+                continue;
+            weights[std::clamp(s, 0, source - 1)] += weight;
+            total += weight;
+        }
+        int first = 0;
+        int last = source - 1;
+        while (first < last && weights[first] == 0.0f)
+            first++;
+        while (last > first && weights[last] == 0.0f)
+            last--;
+        output.first.push_back(first);
+        output.count.push_back(last - first + 1);
+        output.offset.push_back(int(output.weights.size()));
+        for (int s = first; s <= last; ++s)
+            output.weights.push_back(weights[s] / total);
+    }
+    return output;
+}
+//------------------------------------------------------------------------------
+static size_t AlphaCoverage(v4sf const* image, size_t count, float scale, float reference)
+{
+    size_t coverage = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (image[i][3] * scale > reference)
+            coverage++;
+    }
+    return coverage;
+}
+//------------------------------------------------------------------------------
+void TextureTools::MipmapTexture(xxTexturePtr const& texture, int filter, bool gamma, float alphaReference)
 {
     if (texture == nullptr)
         return;
     if (texture->Depth > 1 || texture->Mipmap > 1 || texture->Array > 1)
         return;
-    if (texture->Format != "RGBA8888"_CC && texture->Format != "BGRA8888"_CC)
+    switch (texture->Format)
+    {
+    case "RGBA8888"_CC:
+    case "BGRA8888"_CC:
+        break;
+    case "RGB10A2"_CC:
+    case "R16F"_CC:
+    case "RGBA32F"_CC:
+        gamma = false;
+        break;
+    default:
         return;
+    }
     if ((*texture)() == nullptr)
         return;
 
@@ -177,66 +868,114 @@ void TextureTools::MipmapTexture(xxTexturePtr const& texture)
     memcpy((*texture)(), image, size);
     xxFree(image);
 
+    uint64_t format = texture->Format;
     for (int array = 0; array < texture->Array; ++array)
     {
+        // Level 0 is decoded on demand, the other levels are filtered from the previous one in linear float
+        int sourceWidth = texture->Width;
+        int sourceHeight = texture->Height;
+        v4sf* source = nullptr;
+        v4sf* target = nullptr;
+
+        size_t coverage = 0;
+        if (alphaReference > 0.0f)
+        {
+            v4sf* row = xxAlloc(v4sf, sourceWidth);
+            for (int y = 0; y < sourceHeight; ++y)
+            {
+                DecodeRow(row, (*texture)(0, y, 0, 0, array), sourceWidth, format, gamma);
+                coverage += AlphaCoverage(row, sourceWidth, 1.0f, alphaReference);
+            }
+            xxFree(row);
+        }
+
         for (int mipmap = 1; mipmap < texture->Mipmap; ++mipmap)
         {
-            int levelWidth = (texture->Width >> mipmap);
-            int levelHeight = (texture->Height >> mipmap);
-            int levelDepth = (texture->Depth >> mipmap);
-            if (levelWidth == 0)
-                levelWidth = 1;
-            if (levelHeight == 0)
-                levelHeight = 1;
-            if (levelDepth == 0)
-                levelDepth = 1;
+            int levelWidth = std::max(texture->Width >> mipmap, 1);
+            int levelHeight = std::max(texture->Height >> mipmap, 1);
+            MipmapWeights weightsX = BuildWeights(filter, sourceWidth, levelWidth);
+            MipmapWeights weightsY = BuildWeights(filter, sourceHeight, levelHeight);
+            int rowCount = *std::max_element(weightsY.count.begin(), weightsY.count.end()) + 1;
 
-            for (int depth = 0; depth < levelDepth; ++depth)
+            // Vertical pass on whole rows, then horizontal pass on that row
+            target = xxAlloc(v4sf, size_t(levelWidth) * levelHeight);
+            JobSystem::ParallelFor(levelHeight, 16, [&](size_t begin, size_t end)
             {
-                for (int height = 0; height < levelHeight; ++height)
+                v4sf* row = xxAlloc(v4sf, size_t(sourceWidth) * (source ? 1 : rowCount + 1));
+                v4sf* cache = row + sourceWidth;
+                std::vector<int> cacheRows(rowCount, -1);
+                auto fetch = [&](int y) -> v4sf const*
+                {
+                    if (source)
+                        return source + size_t(y) * sourceWidth;
+                    v4sf* line = cache + size_t(y % rowCount) * sourceWidth;
+                    if (cacheRows[y % rowCount] != y)
+                    {
+                        cacheRows[y % rowCount] = y;
+                        DecodeRow(line, (*texture)(0, y, 0, 0, array), sourceWidth, format, gamma);
+                    }
+                    return line;
+                };
+
+                for (size_t y = begin; y < end; ++y)
                 {
-                    for (int width = 0; width < levelWidth; ++width)
+                    float const* weight = weightsY.weights.data() + weightsY.offset[y];
+                    v4sf const* input = fetch(weightsY.first[y]);
+                    for (int x = 0; x < sourceWidth; ++x)
+                        row[x] = input[x] * weight[0];
+                    for (int i = 1; i < weightsY.count[y]; ++i)
                     {
-                        int r = 0;
-                        int g = 0;
-                        int b = 0;
-                        int a = 0;
-                        int count = 0;
-
-                        int width2 = width * 2;
-                        int height2 = height * 2;
-                        int depth2 = depth * 2;
-                        for (int z = 0; z < 2; ++z)
-                        {
-                            for (int y = 0; y < 2; ++y)
-                            {
-                                for (int x = 0; x < 2; ++x)
-                                {
-                                    unsigned char* right = (unsigned char*)(*texture)(width2 + x, height2 + y, depth2 + z, mipmap - 1, array);
-                                    if (right)
-                                    {
-                                        r += right[0];
-                                        g += right[1];
-                                        b += right[2];
-                                        a += right[3];
-                                        count++;
-                                    }
-                                }
-                            }
-                        }
-
-                        unsigned char* left = (unsigned char*)(*texture)(width, height, depth, mipmap, array);
-                        if (left && count)
-                        {
-                            left[0] = r / count;
-                            left[1] = g / count;
-                            left[2] = b / count;
-                            left[3] = a / count;
-                        }
+                        input = fetch(weightsY.first[y] + i);
+                        for (int x = 0; x < sourceWidth; ++x)
+                            row[x] += input[x] * weight[i];
                     }
+
+                    v4sf* output = target + y * levelWidth;
+                    for (int x = 0; x < levelWidth; ++x)
+                    {
+                        v4sf const* pixel = row + weightsX.first[x];
+                        float const* weight = weightsX.weights.data() + weightsX.offset[x];
+                        v4sf sum = pixel[0] * weight[0];
+                        for (int i = 1; i < weightsX.count[x]; ++i)
+                            sum += pixel[i] * weight[i];
+                        output[x] = sum;
+                    }
+                }
+                xxFree(row);
+            });
+
+            // Scale alpha until the level covers as much as the base level
+            size_t count = size_t(levelWidth) * levelHeight;
+            if (alphaReference > 0.0f)
+            {
+                float ratio = float(coverage) / float(size_t(texture->Width) * texture->Height);
+                float low = 0.0f;
+                float high = 4.0f;
+                for (int i = 0; i < 10; ++i)
+                {
+                    float middle = (low + high) * 0.5f;
+                    if (AlphaCoverage(target, count, middle, alphaReference) < ratio * count)
+                        low = middle;
+                    else
+                        high = middle;
                 }
+                float scale = (low + high) * 0.5f;
+                for (size_t i = 0; i < count; ++i)
+                    target[i][3] = std::min(target[i][3] * scale, 1.0f);
             }
+
+            JobSystem::ParallelFor(levelHeight, 16, [&](size_t begin, size_t end)
+            {
+                for (size_t y = begin; y < end; ++y)
+                    EncodeRow((*texture)(0, int(y), 0, mipmap, array), target + y * levelWidth, levelWidth, format, gamma);
+            });
+
+            xxFree(source);
+            source = target;
+            sourceWidth = levelWidth;
+            sourceHeight = levelHeight;
         }
+        xxFree(source);
     }
 
     texture->Invalidate();
@@ -244,15 +983,15 @@ void TextureTools::MipmapTexture(xxTexturePtr const& texture)
     xxLog(TAG, "MipmapTexture : %s (%.0fus)", texture->Name.c_str(), (xxGetCurrentTime() - begin) * 1000000);
 }
 //------------------------------------------------------------------------------
-void TextureTools::MipmapTextures(xxNodePtr const& node)
+void TextureTools::MipmapTextures(xxNodePtr const& node, int filter, bool gamma, float alphaReference)
 {
-    Node::Traversal(node, [](xxNodePtr const& node)
+    Node::Traversal(node, [=](xxNodePtr const& node)
     {
         if (node->Material)
         {
             for (xxTexturePtr const& texture : node->Material->Textures)
             {
-                MipmapTexture(texture);
+                MipmapTexture(texture, filter, gamma, alphaReference);
             }
         }
         return true;
@@ -8,9 +8,18 @@
 
 struct TextureTools
 {
+    enum MipmapFilter
+    {
+        MIPMAP_BOX,
+        MIPMAP_KAISER,
+        MIPMAP_LANCZOS,
+    };
+
+    static bool CompressSupported(uint64_t source);
     static void CompressTexture(xxTexturePtr const& texture, uint64_t format, std::string const& root, std::string const& subfolder);
-    static void MipmapTexture(xxTexturePtr const& texture);
-    static void MipmapTextures(xxNodePtr const& node);
+    static void BenchmarkCompress(xxTexturePtr const& texture);
+    static void MipmapTexture(xxTexturePtr const& texture, int filter = MIPMAP_BOX, bool gamma = false, float alphaReference = 0.0f);
+    static void MipmapTextures(xxNodePtr const& node, int filter = MIPMAP_BOX, bool gamma = false, float alphaReference = 0.0f);
     static xxTexturePtr CreateGlowTexture();
     static xxTexturePtr CreateStarTexture();
 };
@@ -209,10 +209,9 @@ void Game::Callback(const ImDrawList* list, const ImDrawCmd* cmd)
 
     Profiler::Begin(xxHash("Scene Render"));
     drawData.camera = drawData.camera3D.get();
-    for (Node* node : drawScenes)
-    {
-        node->Draw(drawData);
-    }
+    DrawTools::Stream(drawData, drawScenes, viewport_height);
+    DrawTools::Sort(drawData, drawScenes);
+    DrawTools::Draw(drawData, drawScenes);
     Profiler::End(xxHash("Scene Render"));
 
 #if HAVE_MINIGUI
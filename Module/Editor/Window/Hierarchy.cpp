@@ -101,7 +101,7 @@ static xxNodePtr ImportFile(xxNodePtr const& node, char const* name)
     if (strcasestr(name, ".ply"))
         output = ImportPolygon::Create(name);
     if (strcasestr(name, ".xxb"))
-        output = Binary::Load(name);
+        output = Binary::Load(name, true);
     if (output)
     {
         xxLog("Hierarchy", "Import : %s (%0.fus)", xxFile::GetName(name).c_str(), (xxGetCurrentTime() - begin) * 1000000);
@@ -117,11 +117,16 @@ void Inspector::UpdateNode(const UpdateData& updateData, xxNodePtr const& node)
     if (ImGui::CollapsingHeader(ICON_FA_CUBE "Node" Q, nullptr, ImGuiTreeNodeFlags_DefaultOpen) == false)
         return;
 
-    ImGui::InputTextEx("Name" Q, nullptr, node->Name);
-    ImGui::SliderFloat3("Local" Q, node->LocalMatrix[0], -1.0f, 1.0f);
-    ImGui::SliderFloat3("" Q, node->LocalMatrix[1], -1.0f, 1.0f);
-    ImGui::SliderFloat3("" Q, node->LocalMatrix[2], -1.0f, 1.0f);
-    ImGui::InputFloat3("" Q, node->LocalMatrix[3]);
+    std::string name = node->Name;
+    if (ImGui::InputTextEx("Name" Q, nullptr, name))
+        node->SetName(name);
+    bool local = false;
+    local |= ImGui::SliderFloat3("Local" Q, node->LocalMatrix[0], -1.0f, 1.0f);
+    local |= ImGui::SliderFloat3("" Q, node->LocalMatrix[1], -1.0f, 1.0f);
+    local |= ImGui::SliderFloat3("" Q, node->LocalMatrix[2], -1.0f, 1.0f);
+    local |= ImGui::InputFloat3("" Q, node->LocalMatrix[3]);
+    if (local)
+        node->Flags |= Node::UPDATE_DIRTY;
     ImGui::SliderFloat3("World" Q, node->WorldMatrix[0], -1.0f, 1.0f, "%.3f", ImGuiSliderFlags_NoInput);
     ImGui::SliderFloat3("" Q, node->WorldMatrix[1], -1.0f, 1.0f, "%.3f", ImGuiSliderFlags_NoInput);
     ImGui::SliderFloat3("" Q, node->WorldMatrix[2], -1.0f, 1.0f, "%.3f", ImGuiSliderFlags_NoInput);
@@ -350,7 +355,7 @@ void Inspector::UpdateMesh(const UpdateData& updateData, xxMeshPtr const& mesh)
     ImGui::InputInt2("Vertex" Q, v, ImGuiInputTextFlags_ReadOnly);
     if (ImGui::IsItemHovered()) ImGui::SetTooltip("Vertex Count : %d\nVertex Stride : %d", v[0], v[1]);
     ImGui::InputInt2("Storage" Q, s,  ImGuiInputTextFlags_ReadOnly);
-    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Storage Count : %d\nStorage Stride : %d", s[0], s[1]);
+    if (ImGui::IsItemHovered()) ImGui::SetTooltip("Storage Count : %d\nStorage Stride : %d\nMeshlet Visible : %d", s[0], s[1], mesh->MeshletVisible);
     ImGui::InputFloat3("Bound" Q, (float*)&mesh->Bound, "%.3f", ImGuiInputTextFlags_ReadOnly);
     ImGui::InputFloat("" Q, (float*)&mesh->Bound.radius, 0, 0, "%.3f", ImGuiInputTextFlags_ReadOnly);
 }
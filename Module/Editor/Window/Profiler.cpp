@@ -6,6 +6,8 @@
 //==============================================================================
 #include "Editor.h"
 #include <map>
+#include "Import/ImportWavefront.h"
+#include "Utility/MeshTools.h"
 #include "Profiler.h"
 
 static std::map<unsigned int, std::pair<char const*, double>> times;
@@ -41,6 +43,13 @@ bool Profiler::Update(const UpdateData& updateData, bool& show)
             uint64_t value = uint64_t(pair.second);
             ImGui::InputScalar(pair.first, ImGuiDataType_U64, &value, nullptr, nullptr, "%'llu", ImGuiInputTextFlags_ReadOnly);
         }
+        if (ImGui::CollapsingHeader("Benchmark"))
+        {
+            if (ImGui::Button("Indexing Mesh"))
+                MeshTools::BenchmarkIndexing();
+            if (ImGui::Button("Import Wavefront"))
+                ImportWavefront::Benchmark();
+        }
     }
     ImGui::End();
 
@@ -111,6 +120,36 @@ void Profiler::Count(unsigned int hashName, size_t count)
     case xxHash("Node Active Count"):
         counters[hashName] = {"Node Active Count", count};
         break;
+    case xxHash("Shader Cache Hit"):
+        counters[hashName] = {"Shader Cache Hit", count};
+        break;
+    case xxHash("Shader Cache Miss"):
+        counters[hashName] = {"Shader Cache Miss", count};
+        break;
+    case xxHash("Texture Resident"):
+        counters[hashName] = {"Texture Resident (KB)", count};
+        break;
+    case xxHash("Texture Pending"):
+        counters[hashName] = {"Texture Pending", count};
+        break;
+    case xxHash("BVH Refit"):
+        counters[hashName] = {"BVH Refit", count};
+        break;
+    case xxHash("Bind Request"):
+        counters[hashName] = {"Bind Request", count};
+        break;
+    case xxHash("Bind Count"):
+        counters[hashName] = {"Bind Count", count};
+        break;
+    case xxHash("Constant Frame"):
+        counters[hashName] = {"Constant Frame (KB)", count};
+        break;
+    case xxHash("Constant High Water"):
+        counters[hashName] = {"Constant High Water (KB)", count};
+        break;
+    case xxHash("Constant Buffer"):
+        counters[hashName] = {"Constant Buffer", count};
+        break;
     }
 }
 //------------------------------------------------------------------------------
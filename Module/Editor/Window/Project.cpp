@@ -113,6 +113,7 @@ static void ShowFolders(std::string const& root, std::string& selected)
             {
                 xxTexturePtr texture;
                 if (strcasestr(filename, ".dds") ||
+                    strcasestr(filename, ".ktx2") ||
                     strcasestr(filename, ".jpg") ||
                     strcasestr(filename, ".png"))
                 {
@@ -208,11 +209,19 @@ static void ShowFiles(const UpdateData& updateData, std::string const& root, std
         if (selected == &attribute && ImGui::BeginPopup("RightProjectTexture"))
         {
             uint64_t format = 0;
-            if (ImGui::Button("Compress BC1"))  format = "BC1"_cc;
-            if (ImGui::Button("Compress BC2"))  format = "BC2"_cc;
-            if (ImGui::Button("Compress BC3"))  format = "BC3"_cc;
-            if (ImGui::Button("Compress BC4U")) format = "BC4U"_cc;
-            if (ImGui::Button("Compress BC5U")) format = "BC5U"_cc;
+            bool ldr = attribute.texture->Format == "RGBA8888"_CC;
+            if (ldr && ImGui::Button("Compress BC1"))   format = "BC1"_cc;
+            if (ldr && ImGui::Button("Compress BC2"))   format = "BC2"_cc;
+            if (ldr && ImGui::Button("Compress BC3"))   format = "BC3"_cc;
+            if (ldr && ImGui::Button("Compress BC4U"))  format = "BC4U"_cc;
+            if (ldr && ImGui::Button("Compress BC5U"))  format = "BC5U"_cc;
+            if (ImGui::Button("Compress BC6H"))         format = "BC6H"_cc;
+            if (ldr && ImGui::Button("Compress BC7"))   format = "BC7"_cc;
+            if (ImGui::Button("Benchmark"))
+            {
+                TextureTools::BenchmarkCompress(attribute.texture);
+                selected = nullptr;
+            }
             if (format)
             {
                 TextureTools::CompressTexture(attribute.texture, format, root, subfolder);
@@ -224,7 +233,7 @@ static void ShowFiles(const UpdateData& updateData, std::string const& root, std
         {
             if (attribute.texture && attribute.texture->Format)
             {
-                if (attribute.texture->Format == "RGBA8888"_CC && ImGui::IsItemClicked(ImGuiMouseButton_Right))
+                if (TextureTools::CompressSupported(attribute.texture->Format) && ImGui::IsItemClicked(ImGuiMouseButton_Right))
                 {
                     ImGui::OpenPopup("RightProjectTexture");
                     selected = &attribute;
@@ -7,11 +7,16 @@
 #include "Editor.h"
 #include <xxGraphicPlus/xxModifier.h>
 #include <xxGraphicPlus/xxTexture.h>
+#include <Runtime/Graphic/Binding.h>
+#include <Runtime/Graphic/Buffer.h>
 #include <Runtime/Graphic/Camera.h>
 #include <Runtime/Graphic/Material.h>
 #include <Runtime/Graphic/Mesh.h>
 #include <Runtime/Graphic/Node.h>
+#include <Runtime/Graphic/Shader.h>
+#include <Runtime/Graphic/Texture.h>
 #include <ImGuizmo/ImGuizmo.cpp>
+#include <Tools/BVH.h>
 #include <Tools/CameraTools.h>
 #include <Tools/DrawTools.h>
 #include <Tools/NodeTools.h>
@@ -40,8 +45,13 @@ static xxVector2 viewPos;
 static xxVector2 viewSize;
 static ImGuiViewport* viewViewport;
 static std::vector<Node*> drawScenes;
+static std::vector<Node*> updateScenes;
 static std::vector<Node*> drawGUIs;
+static BVH sceneBVH;
+static size_t sceneSignature;
 static bool cullEnabled = false;
+static bool sortEnabled = true;
+static bool bvhEnabled = true;
 static bool drawBoneLine = false;
 static bool drawNodeLine = false;
 static bool drawNodeBound = false;
@@ -117,7 +127,10 @@ void Scene::Shutdown(bool suspend)
     selecting = nullptr;
     viewViewport = nullptr;
     drawScenes = std::vector<Node*>();
+    updateScenes = std::vector<Node*>();
     drawGUIs = std::vector<Node*>();
+    sceneBVH.Clear();
+    sceneSignature = 0;
 }
 //------------------------------------------------------------------------------
 void Scene::Select(xxNodePtr const& node)
@@ -295,6 +308,7 @@ static void SelectMouse()
                 {
                     selected->LocalMatrix = world;
                 }
+                selected->Flags |= Node::UPDATE_DIRTY;
                 selected->UpdateMatrix();
             }
         }
@@ -544,8 +558,9 @@ bool Scene::Update(const UpdateData& updateData, bool& show)
             size_t nodeActive;
             size_t modifierTotal;
             size_t modifierActive;
+            size_t signature;
         } Count = {};
-        auto callback = [&](xxNodePtr const& node)
+        auto callback = [&](Node* node)
         {
             node->Flags &= ~NodeTools::TEST_CHECK_FLAG;
             for (auto const& data : node->Bones)
@@ -561,6 +576,7 @@ bool Scene::Update(const UpdateData& updateData, bool& show)
                 }
             }
             Count.nodeTotal++;
+            Count.signature = Count.signature * 31 + size_t(node) + size_t(node->Mesh.get());
             Count.modifierTotal += node->Modifiers.size();
             if ((node->Flags & xxNode::UPDATE_SKIP) == 0)
             {
@@ -575,28 +591,57 @@ bool Scene::Update(const UpdateData& updateData, bool& show)
             if (MiniGUI::Window::Cast(node))
                 continue;
 #endif
-            Node::Traversal(node, callback);
+            Node::Visit(node, callback);
         }
         Profiler::Count(xxHash("Bone Count"), Count.bone);
         Profiler::Count(xxHash("Node Total Count"), Count.nodeTotal);
         Profiler::Count(xxHash("Node Active Count"), Count.nodeActive);
         Profiler::Count(xxHash("Modifier Total Count"), Count.modifierTotal);
         Profiler::Count(xxHash("Modifier Active Count"), Count.modifierActive);
+        Profiler::Count(xxHash("Shader Cache Hit"), Shader::CacheHit);
+        Profiler::Count(xxHash("Shader Cache Miss"), Shader::CacheMiss);
+        if (Texture::IsStreaming())
+        {
+            Texture::StreamingStatistics statistics = Texture::GetStreamingStatistics();
+            Profiler::Count(xxHash("Texture Resident"), statistics.residentBytes / 1024);
+            Profiler::Count(xxHash("Texture Pending"), statistics.pendingCount);
+        }
+        Buffer::ConstantStatistics constantStatistics = Buffer::GetConstantStatistics();
+        Profiler::Count(xxHash("Constant Frame"), constantStatistics.frameBytes / 1024);
+        Profiler::Count(xxHash("Constant High Water"), constantStatistics.highWaterBytes / 1024);
+        Profiler::Count(xxHash("Constant Buffer"), constantStatistics.bufferCount);
         updated |= Count.modifierTotal != 0;
 
         // Scene
         Profiler::Begin(xxHash("Scene Update"));
+        updateScenes.clear();
         for (xxNodePtr const& node : (*sceneRoot))
         {
 #if HAVE_MINIGUI
             if (MiniGUI::Window::Cast(node))
                 continue;
 #endif
-            node->Update(updateData.time);
+            updateScenes.push_back(node.get());
         }
+        NodeTools::Update(updateScenes, updateData.time);
         sceneRoot->UpdateBound();
         Profiler::End(xxHash("Scene Update"));
 
+        // BVH
+        if (bvhEnabled)
+        {
+            if (sceneSignature != Count.signature || sceneBVH.GetNodeCount() == 0)
+            {
+                sceneSignature = Count.signature;
+                sceneBVH.Build(sceneRoot);
+            }
+            else
+            {
+                sceneBVH.Refit();
+            }
+            Profiler::Count(xxHash("BVH Refit"), sceneBVH.GetRefitCount());
+        }
+
 #if HAVE_MINIGUI
         // MiniGUI
         Profiler::Begin(xxHash("MiniGUI Update"));
@@ -633,6 +678,15 @@ bool Scene::Update(const UpdateData& updateData, bool& show)
         ImGui::Checkbox("##3", &drawNodeLine);  if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", "Draw Node Line");
         ImGui::SameLine();
         ImGui::Checkbox("##4", &drawNodeBound); if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", "Draw Node Bound");
+        ImGui::SameLine();
+        ImGui::Checkbox("##5", &sortEnabled);   if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", "Sort Draw List");
+        ImGui::SameLine();
+        ImGui::Checkbox("##6", &bvhEnabled);    if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", "Culling with BVH");
+        ImGui::SameLine();
+        bool streaming = Texture::IsStreaming();
+        if (ImGui::Checkbox("##7", &streaming))
+            Texture::SetStreaming(streaming);
+        if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", "Texture Streaming");
 
         sceneCamera = nullptr;
         for (xxNodePtr const& node : (*Scene::sceneRoot))
@@ -691,7 +745,10 @@ bool Scene::Update(const UpdateData& updateData, bool& show)
         updated |= CameraMoveWASD(updateData, mani);
         updated |= CameraMoveManipulate(mani, maniSize, maniPos);
 
-        DrawTools::Cull(sceneRoot, cullEnabled ? sceneCamera : mainCamera, drawScenes, &drawGUIs, false);
+        if (bvhEnabled)
+            DrawTools::Cull(sceneBVH, sceneRoot, cullEnabled ? sceneCamera : mainCamera, drawScenes, &drawGUIs, false);
+        else
+            DrawTools::Cull(sceneRoot, cullEnabled ? sceneCamera : mainCamera, drawScenes, &drawGUIs, false);
     }
     ImGui::End();
 
@@ -763,11 +820,15 @@ void Scene::Callback(const ImDrawList* list, const ImDrawCmd* cmd)
     }
 
     Profiler::Begin(xxHash("Scene Render"));
+    size_t bindRequest = Binding::RequestCount;
+    size_t bindCount = Binding::BindCount;
     drawData.camera = drawData.camera3D.get();
-    for (Node* node : drawScenes)
-    {
-        node->Draw(drawData);
-    }
+    DrawTools::Stream(drawData, drawScenes, viewport_height);
+    if (sortEnabled)
+        DrawTools::Sort(drawData, drawScenes);
+    DrawTools::Draw(drawData, drawScenes);
+    Profiler::Count(xxHash("Bind Request"), Binding::RequestCount - bindRequest);
+    Profiler::Count(xxHash("Bind Count"), Binding::BindCount - bindCount);
     Profiler::End(xxHash("Scene Render"));
 
     DrawTools::Draw(drawData, sceneGrid);
@@ -6,9 +6,30 @@
 //==============================================================================
 #include "Runtime.h"
 #include <xxGraphicPlus/xxFile.h>
+#include "Graphic/Mesh.h"
 #include "Graphic/Node.h"
+#include "Tools/Compression.h"
 #include "Binary.h"
 
+#if defined(xxWINDOWS)
+#include <Tools/WindowsHeader.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define TAG "Binary"
+
+//==============================================================================
+struct ChunkHeader
+{
+    uint32_t size;
+    uint32_t count;
+    uint64_t total;
+};
+static_assert(sizeof(ChunkHeader) == 16);
 //==============================================================================
 //  Binary
 //==============================================================================
@@ -19,9 +40,11 @@ Binary::Binary()
 //------------------------------------------------------------------------------
 Binary::~Binary()
 {
+    CloseChunk();
+    UnmapStream();
 }
 //------------------------------------------------------------------------------
-xxNodePtr Binary::Load(char const* name)
+xxNodePtr Binary::Load(char const* name, bool mapping)
 {
     xxNodePtr node;
 
@@ -43,6 +66,12 @@ xxNodePtr Binary::Load(char const* name)
         {
             const_cast<int&>(binary.Version) = xxNTOHL(version);
 
+            if (binary.Version == Compressed)
+            {
+                const_cast<int&>(binary.Version) = Current;
+                binary.m_compressed = true;
+            }
+
             if ((binary.Version & 1) == 1)
             {
                 delete file;
@@ -50,6 +79,10 @@ xxNodePtr Binary::Load(char const* name)
                 return (xxNodePtr&)output;
             }
 
+            if (mapping)
+            {
+                binary.MapStream(name);
+            }
             if (binary.ReadStream())
             {
                 auto output = xxNode::BinaryCreate();
@@ -63,6 +96,16 @@ xxNodePtr Binary::Load(char const* name)
             {
                 node = nullptr;
             }
+            if (node && binary.m_lendable.empty() == false)
+            {
+                Node::Traversal(node, [&](xxNodePtr const& node)
+                {
+                    Mesh* mesh = (Mesh*)node->Mesh.get();
+                    if (mesh)
+                        mesh->Lend(binary);
+                    return 0;
+                });
+            }
         }
 
         delete file;
@@ -72,7 +115,7 @@ xxNodePtr Binary::Load(char const* name)
     return node;
 }
 //------------------------------------------------------------------------------
-bool Binary::Save(char const* name, xxNodePtr const& node)
+bool Binary::Save(char const* name, xxNodePtr const& node, bool compress)
 {
     bool succeed = false;
 
@@ -80,7 +123,7 @@ bool Binary::Save(char const* name, xxNodePtr const& node)
     if (file)
     {
         Binary binary;
-        int version = xxHTONL(binary.Version);
+        int version = xxHTONL(compress ? Compressed : binary.Version);
 
         binary.m_file = file;
         binary.m_reference.resize(1);
@@ -97,7 +140,7 @@ bool Binary::Save(char const* name, xxNodePtr const& node)
             }
             if (binary.Safe)
             {
-                succeed = binary.WriteStream();
+                succeed = binary.WriteStream(compress);
             }
         }
 
@@ -110,29 +153,52 @@ bool Binary::Save(char const* name, xxNodePtr const& node)
 //------------------------------------------------------------------------------
 bool Binary::ReadStream()
 {
-    size_t position = m_file->Position();
-    size_t size = m_file->Size();
-    if (position >= size)
-        return false;
-    m_binaryStream.resize(size - position);
-    if (m_file->Read(m_binaryStream.data(), m_binaryStream.size()) != m_binaryStream.size())
+    if (m_binaryData == nullptr)
+    {
+        size_t position = m_file->Position();
+        size_t size = m_file->Size();
+        if (position >= size)
+            return false;
+        m_binaryStream.resize(size - position);
+        if (m_file->Read(m_binaryStream.data(), m_binaryStream.size()) != m_binaryStream.size())
+            return false;
+        m_binaryStream.push_back(0);
+        m_binaryData = m_binaryStream.data();
+        m_binarySize = m_binaryStream.size();
+    }
+    if (m_compressed && OpenChunk() == false)
         return false;
-    m_binaryStream.push_back(0);
 
+    char const* stream = (char const*)m_binaryData;
     for (;;)
     {
-        std::string string = (char*)m_binaryStream.data() + m_binaryStreamPosition;
-        if (string.empty())
+        size_t begin = m_binaryStreamPosition;
+        size_t end = begin;
+        for (;;)
+        {
+            if (end >= m_binarySize)
+                return false;
+            size_t span = m_binarySize;
+            if (m_chunkSize)
+                span = std::min(span, (end / m_chunkSize + 1) * m_chunkSize);
+            if (ReadChunk(end, span) == false)
+                return false;
+            size_t length = strnlen(stream + end, span - end);
+            end += length;
+            if (end < span)
+                break;
+        }
+        if (end == begin)
             break;
-        m_stringStream.push_back(string);
-        m_binaryStreamPosition += string.length() + 1;
+        m_stringStream.emplace_back(stream + begin, end - begin);
+        m_binaryStreamPosition = end + 1;
     }
     m_binaryStreamPosition++;
 
     return true;
 }
 //------------------------------------------------------------------------------
-bool Binary::WriteStream()
+bool Binary::WriteStream(bool compress)
 {
     std::vector<uint8_t> binaryStream;
     m_binaryStream.swap(binaryStream);
@@ -147,6 +213,12 @@ bool Binary::WriteStream()
     }
     m_binaryStream.push_back(0);
 
+    if (compress)
+    {
+        m_binaryStream.insert(m_binaryStream.end(), binaryStream.begin(), binaryStream.end());
+        return WriteChunk(m_binaryStream);
+    }
+
     if (m_file->Write(m_binaryStream.data(), m_binaryStream.size()) != m_binaryStream.size())
         return false;
     if (m_file->Write(binaryStream.data(), binaryStream.size()) != binaryStream.size())
@@ -154,18 +226,251 @@ bool Binary::WriteStream()
     return true;
 }
 //------------------------------------------------------------------------------
+bool Binary::MapStream(char const* name)
+{
+    size_t position = m_file->Position();
+    void* data = nullptr;
+    size_t size = 0;
+
+#if defined(xxWINDOWS)
+    int length = MultiByteToWideChar(CP_UTF8, 0, name, -1, nullptr, 0);
+    std::wstring wide(length, 0);
+    MultiByteToWideChar(CP_UTF8, 0, name, -1, wide.data(), length);
+    HANDLE file = CreateFileW(wide.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize = {};
+    GetFileSizeEx(file, &fileSize);
+    size = size_t(fileSize.QuadPart);
+    HANDLE mapping = size ? CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (mapping == nullptr)
+        return false;
+    data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr)
+        return false;
+    m_mapping = std::shared_ptr<void>(data, [](void* data) { UnmapViewOfFile(data); });
+#else
+    int file = open(name, O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat stat = {};
+    fstat(file, &stat);
+    size = size_t(stat.st_size);
+    // Private writable pages, so lent arrays can be modified in place by copy on write
+    data = size ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0) : MAP_FAILED;
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+    madvise(data, size, MADV_SEQUENTIAL);
+    m_mapping = std::shared_ptr<void>(data, [size](void* data) { munmap(data, size); });
+#endif
+
+    if (position >= size)
+    {
+        UnmapStream();
+        return false;
+    }
+    m_binaryData = (uint8_t*)data + position;
+    m_binarySize = size - position;
+    return true;
+}
+//------------------------------------------------------------------------------
+void Binary::UnmapStream()
+{
+    // Meshes holding lent arrays keep the mapping alive
+    m_lendable.clear();
+    m_mapping = nullptr;
+}
+//------------------------------------------------------------------------------
+bool Binary::OpenChunk()
+{
+    ChunkHeader header;
+    if (m_binarySize < sizeof(ChunkHeader))
+        return false;
+    memcpy(&header, m_binaryData, sizeof(ChunkHeader));
+    if (header.size != ChunkSize || header.count != (header.total + header.size - 1) / header.size)
+        return false;
+    if (header.total > uint64_t(header.count) * ChunkSize)
+        return false;
+
+    size_t indexSize = sizeof(uint32_t) * header.count;
+    if (m_binarySize - sizeof(ChunkHeader) < indexSize)
+        return false;
+    m_chunkLengths.resize(header.count);
+    memcpy(m_chunkLengths.data(), m_binaryData + sizeof(ChunkHeader), indexSize);
+
+    uint64_t offset = 0;
+    m_chunkOffsets.resize(header.count + 1);
+    for (uint32_t i = 0; i < header.count; ++i)
+    {
+        m_chunkOffsets[i] = offset;
+        offset += m_chunkLengths[i] & INT32_MAX;
+    }
+    m_chunkOffsets[header.count] = offset;
+    if (m_binarySize - sizeof(ChunkHeader) - indexSize < offset)
+        return false;
+
+    m_chunkData = m_binaryData + sizeof(ChunkHeader) + indexSize;
+    m_chunkSize = header.size;
+    m_chunkStream = std::unique_ptr<uint8_t[]>(new uint8_t[header.total + 1]);
+    m_chunkStream[header.total] = 0;
+    m_chunkStates = std::unique_ptr<std::atomic<char>[]>(new std::atomic<char>[header.count]);
+    for (uint32_t i = 0; i < header.count; ++i)
+        m_chunkStates[i] = 0;
+    m_binaryData = m_chunkStream.get();
+    m_binarySize = header.total + 1;
+
+    // Decode ahead of the reader
+    size_t threadCount = std::min<size_t>(std::thread::hardware_concurrency(), 8);
+    threadCount = std::min<size_t>(threadCount, header.count);
+    threadCount = threadCount ? threadCount - 1 : 0;
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        m_chunkThreads.emplace_back([this]()
+        {
+            for (size_t index = m_chunkNext++; index < m_chunkLengths.size(); index = m_chunkNext++)
+            {
+                DecodeChunk(index);
+            }
+        });
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+void Binary::CloseChunk()
+{
+    m_chunkNext = m_chunkLengths.size();
+    for (std::thread& thread : m_chunkThreads)
+        thread.join();
+    m_chunkThreads.clear();
+}
+//------------------------------------------------------------------------------
+bool Binary::ReadChunk(size_t begin, size_t end)
+{
+    if (m_chunkStates == nullptr)
+        return true;
+    size_t count = m_chunkLengths.size();
+    for (size_t index = begin / m_chunkSize; index < count && index * m_chunkSize < end; ++index)
+    {
+        if (DecodeChunk(index) == false)
+            return false;
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+bool Binary::DecodeChunk(size_t index)
+{
+    std::atomic<char>& state = m_chunkStates[index];
+    char expected = 0;
+    if (state.compare_exchange_strong(expected, 1, std::memory_order_acquire) == false)
+    {
+        while (expected == 1)
+        {
+            std::this_thread::yield();
+            expected = state.load(std::memory_order_acquire);
+        }
+        return expected == 2;
+    }
+
+    uint8_t const* source = m_chunkData + m_chunkOffsets[index];
+    size_t sourceSize = m_chunkLengths[index] & INT32_MAX;
+    uint8_t* target = m_chunkStream.get() + index * m_chunkSize;
+    size_t targetSize = std::min(m_chunkSize, m_binarySize - 1 - index * m_chunkSize);
+
+    bool succeed = false;
+    if (m_chunkLengths[index] & ~INT32_MAX)
+    {
+        succeed = (sourceSize == targetSize);
+        if (succeed)
+        {
+            memcpy(target, source, targetSize);
+        }
+    }
+    else
+    {
+        succeed = (Compression::Decompress(source, sourceSize, target, targetSize) == targetSize);
+    }
+    state.store(succeed ? 2 : 3, std::memory_order_release);
+    return succeed;
+}
+//------------------------------------------------------------------------------
+bool Binary::WriteChunk(std::vector<uint8_t> const& stream)
+{
+    ChunkHeader header;
+    header.size = ChunkSize;
+    header.count = uint32_t((stream.size() + ChunkSize - 1) / ChunkSize);
+    header.total = stream.size();
+
+    std::vector<uint32_t> lengths(header.count);
+    std::vector<uint8_t> chunks;
+    std::vector<uint8_t> buffer(Compression::Bound(ChunkSize));
+    for (uint32_t i = 0; i < header.count; ++i)
+    {
+        uint8_t const* source = stream.data() + size_t(i) * ChunkSize;
+        size_t sourceSize = std::min<size_t>(ChunkSize, stream.size() - size_t(i) * ChunkSize);
+        size_t length = Compression::Compress(source, sourceSize, buffer.data(), buffer.size());
+        if (length == 0 || length >= sourceSize)
+        {
+            lengths[i] = uint32_t(sourceSize) | ~uint32_t(INT32_MAX);
+            chunks.insert(chunks.end(), source, source + sourceSize);
+        }
+        else
+        {
+            lengths[i] = uint32_t(length);
+            chunks.insert(chunks.end(), buffer.data(), buffer.data() + length);
+        }
+    }
+
+    if (m_file->Write(&header, sizeof(ChunkHeader)) != sizeof(ChunkHeader))
+        return false;
+    if (m_file->Write(lengths.data(), sizeof(uint32_t) * lengths.size()) != sizeof(uint32_t) * lengths.size())
+        return false;
+    if (m_file->Write(chunks.data(), chunks.size()) != chunks.size())
+        return false;
+
+    xxLog(TAG, "Compressed %zu to %zu bytes in %u chunks", stream.size(), chunks.size(), header.count);
+    return true;
+}
+//------------------------------------------------------------------------------
 bool Binary::Read(void* data, size_t size)
+{
+    void const* pointer = ReadPointer(size);
+    if (pointer == nullptr)
+        return false;
+    memcpy(data, pointer, size);
+    if (m_mapping && m_compressed == false && size >= LendSize)
+        m_lendable[data] = { (uint8_t const*)pointer - m_binaryData, size };
+    return true;
+}
+//------------------------------------------------------------------------------
+void const* Binary::ReadPointer(size_t size)
 {
     m_called++;
-    if (m_binaryStream.size() < m_binaryStreamPosition + size)
+    if (m_binarySize < m_binaryStreamPosition + size || ReadChunk(m_binaryStreamPosition, m_binaryStreamPosition + size) == false)
     {
         m_failed = m_called;
         const_cast<bool&>(Safe) = false;
-        return false;
+        return nullptr;
     }
-    memcpy(data, m_binaryStream.data() + m_binaryStreamPosition, size);
+    void const* pointer = m_binaryData + m_binaryStreamPosition;
     m_binaryStreamPosition += size;
-    return true;
+    return pointer;
+}
+//------------------------------------------------------------------------------
+void const* Binary::Lend(void const* data, size_t size, size_t alignment) const
+{
+    auto it = m_lendable.find(data);
+    if (it == m_lendable.end() || (*it).second.second != size)
+        return nullptr;
+    void const* pointer = m_binaryData + (*it).second.first;
+    if (uintptr_t(pointer) % alignment)
+        return nullptr;
+    if (memcmp(data, pointer, size) != 0)
+        return nullptr;
+    return pointer;
 }
 //------------------------------------------------------------------------------
 bool Binary::Write(void const* data, size_t size)
@@ -7,13 +7,16 @@
 #pragma once
 
 #include "Runtime.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 #include <xxGraphicPlus/xxBinary.h>
 
 class RuntimeAPI Binary : public xxBinary
 {
 public:
-    static xxNodePtr            Load(char const* name);
-    static bool                 Save(char const* name, xxNodePtr const& node);
+    static xxNodePtr            Load(char const* name, bool mapping = false);
+    static bool                 Save(char const* name, xxNodePtr const& node, bool compress = false);
 
 protected:
     Binary();
@@ -23,17 +26,56 @@ protected:
     bool                        Write(void const* data, size_t size) override;
 
     bool                        ReadStream();
-    bool                        WriteStream();
+    bool                        WriteStream(bool compress);
+
+    bool                        MapStream(char const* name);
+    void                        UnmapStream();
+
+    bool                        OpenChunk();
+    void                        CloseChunk();
+    bool                        ReadChunk(size_t begin, size_t end);
+    bool                        DecodeChunk(size_t index);
+    bool                        WriteChunk(std::vector<uint8_t> const& stream);
 
     size_t                      m_binaryStreamPosition = 0;
     std::vector<uint8_t>        m_binaryStream;
     std::vector<std::string>    m_stringStream;
 
+    uint8_t const*              m_binaryData = nullptr;
+    size_t                      m_binarySize = 0;
+    std::shared_ptr<void>       m_mapping;
+
+    std::unordered_map<void const*, std::pair<size_t, size_t>>
+                                m_lendable;
+
+    bool                        m_compressed = false;
+    size_t                      m_chunkSize = 0;
+    uint8_t const*              m_chunkData = nullptr;
+    std::vector<uint64_t>       m_chunkOffsets;
+    std::vector<uint32_t>       m_chunkLengths;
+    std::unique_ptr<uint8_t[]>  m_chunkStream;
+    std::unique_ptr<std::atomic<char>[]>
+                                m_chunkStates;
+    std::atomic<size_t>         m_chunkNext = 0;
+    std::vector<std::thread>    m_chunkThreads;
+
 public:
     bool                        ReadString(std::string& string) override;
     bool                        WriteString(std::string const& string) override;
 
+    // The pointer is valid until Load returns, or while the mapping is held
+    void const*                 ReadPointer(size_t size);
+    template<class T> T const*  ReadPointer(size_t count) { return (T const*)ReadPointer(sizeof(T) * count); }
+
+    // The mapped bytes an earlier Read copied into data, when they are unchanged and aligned
+    void const*                 Lend(void const* data, size_t size, size_t alignment) const;
+    std::shared_ptr<void> const&
+                                Mapping() const { return m_mapping; }
+
     static int constexpr        Current = 0x20241222;
+    static int constexpr        Compressed = 0x20261018;
+    static int constexpr        ChunkSize = 65536;
+    static int constexpr        LendSize = 4096;
 };
 
 #if defined(xxWINDOWS)
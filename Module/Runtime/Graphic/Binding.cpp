@@ -16,6 +16,9 @@
 #endif
 
 //==============================================================================
+size_t Binding::RequestCount;
+size_t Binding::BindCount;
+//------------------------------------------------------------------------------
 static struct { int x; int y; int width; int height; float minZ; float maxZ; } bindViewport;
 static struct { int x; int y; int width; int height; } bindScissor;
 static uint64_t bindPipeline;
@@ -62,30 +65,37 @@ static void xxEndRenderPassRuntime(uint64_t commandEncoder, uint64_t framebuffer
 //------------------------------------------------------------------------------
 static void xxSetViewportRuntime(uint64_t commandEncoder, int x, int y, int width, int height, float minZ, float maxZ)
 {
+    Binding::RequestCount++;
     if (bindViewport.x == x && bindViewport.y == y && bindViewport.width == width && bindViewport.height == height && bindViewport.minZ == minZ && bindViewport.maxZ == maxZ)
         return;
     bindViewport = {x, y, width, height, minZ, maxZ};
+    Binding::BindCount++;
     xxSetViewportSystem(commandEncoder, x, y, width, height, minZ, maxZ);
 }
 //------------------------------------------------------------------------------
 static void xxSetScissorRuntime(uint64_t commandEncoder, int x, int y, int width, int height)
 {
+    Binding::RequestCount++;
     if (bindScissor.x == x && bindScissor.y == y && bindScissor.width == width && bindScissor.height == height)
         return;
     bindScissor = {x, y, width, height};
+    Binding::BindCount++;
     xxSetScissorSystem(commandEncoder, x, y, width, height);
 }
 //------------------------------------------------------------------------------
 static void xxSetPipelineRuntime(uint64_t commandEncoder, uint64_t pipeline)
 {
+    Binding::RequestCount++;
     if (bindPipeline == pipeline)
         return;
     bindPipeline = pipeline;
+    Binding::BindCount++;
     xxSetPipelineSystem(commandEncoder, pipeline);
 }
 //------------------------------------------------------------------------------
 static void xxSetMeshBuffersRuntime(uint64_t commandEncoder, int count, const uint64_t* buffers)
 {
+    Binding::RequestCount++;
     bool update = false;
     for (int i = 0; i < count; ++i)
     {
@@ -97,11 +107,13 @@ static void xxSetMeshBuffersRuntime(uint64_t commandEncoder, int count, const ui
     }
     if (update == false)
         return;
+    Binding::BindCount++;
     xxSetMeshBuffersSystem(commandEncoder, count, buffers);
 }
 //------------------------------------------------------------------------------
 static void xxSetVertexBuffersRuntime(uint64_t commandEncoder, int count, const uint64_t* buffers, uint64_t vertexAttribute)
 {
+    Binding::RequestCount++;
     bool update = false;
     for (int i = 0; i < count; ++i)
     {
@@ -113,11 +125,13 @@ static void xxSetVertexBuffersRuntime(uint64_t commandEncoder, int count, const
     }
     if (update == false)
         return;
+    Binding::BindCount++;
     xxSetVertexBuffersSystem(commandEncoder, count, buffers, vertexAttribute);
 }
 //------------------------------------------------------------------------------
 static void xxSetVertexTexturesRuntime(uint64_t commandEncoder, int count, const uint64_t* textures)
 {
+    Binding::RequestCount++;
     bool update = false;
     for (int i = 0; i < count; ++i)
     {
@@ -129,11 +143,13 @@ static void xxSetVertexTexturesRuntime(uint64_t commandEncoder, int count, const
     }
     if (update == false)
         return;
+    Binding::BindCount++;
     xxSetVertexTexturesSystem(commandEncoder, count, textures);
 }
 //------------------------------------------------------------------------------
 static void xxSetFragmentTexturesRuntime(uint64_t commandEncoder, int count, const uint64_t* textures)
 {
+    Binding::RequestCount++;
     bool update = false;
     for (int i = 0; i < count; ++i)
     {
@@ -145,11 +161,13 @@ static void xxSetFragmentTexturesRuntime(uint64_t commandEncoder, int count, con
     }
     if (update == false)
         return;
+    Binding::BindCount++;
     xxSetFragmentTexturesSystem(commandEncoder, count, textures);
 }
 //------------------------------------------------------------------------------
 static void xxSetVertexSamplersRuntime(uint64_t commandEncoder, int count, const uint64_t* samplers)
 {
+    Binding::RequestCount++;
     bool update = false;
     for (int i = 0; i < count; ++i)
     {
@@ -161,11 +179,13 @@ static void xxSetVertexSamplersRuntime(uint64_t commandEncoder, int count, const
     }
     if (update == false)
         return;
+    Binding::BindCount++;
     xxSetVertexSamplersSystem(commandEncoder, count, samplers);
 }
 //------------------------------------------------------------------------------
 static void xxSetFragmentSamplersRuntime(uint64_t commandEncoder, int count, const uint64_t* samplers)
 {
+    Binding::RequestCount++;
     bool update = false;
     for (int i = 0; i < count; ++i)
     {
@@ -177,30 +197,37 @@ static void xxSetFragmentSamplersRuntime(uint64_t commandEncoder, int count, con
     }
     if (update == false)
         return;
+    Binding::BindCount++;
     xxSetFragmentSamplersSystem(commandEncoder, count, samplers);
 }
 //------------------------------------------------------------------------------
 static void xxSetMeshConstantBufferRuntime(uint64_t commandEncoder, uint64_t buffer, int size)
 {
+    Binding::RequestCount++;
     if (bindMeshConstantBuffer == buffer)
         return;
     bindMeshConstantBuffer = buffer;
+    Binding::BindCount++;
     xxSetMeshConstantBufferSystem(commandEncoder, buffer, size);
 }
 //------------------------------------------------------------------------------
 static void xxSetVertexConstantBufferRuntime(uint64_t commandEncoder, uint64_t buffer, int size)
 {
+    Binding::RequestCount++;
     if (bindVertexConstantBuffer == buffer)
         return;
     bindVertexConstantBuffer = buffer;
+    Binding::BindCount++;
     xxSetVertexConstantBufferSystem(commandEncoder, buffer, size);
 }
 //------------------------------------------------------------------------------
 static void xxSetFragmentConstantBufferRuntime(uint64_t commandEncoder, uint64_t buffer, int size)
 {
+    Binding::RequestCount++;
     if (bindFragmentConstantBuffer == buffer)
         return;
     bindFragmentConstantBuffer = buffer;
+    Binding::BindCount++;
     xxSetFragmentConstantBufferSystem(commandEncoder, buffer, size);
 }
 //==============================================================================
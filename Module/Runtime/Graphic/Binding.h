@@ -12,4 +12,7 @@ struct RuntimeAPI Binding
 {
     static void Initialize();
     static void Shutdown();
+
+    static size_t RequestCount;
+    static size_t BindCount;
 };
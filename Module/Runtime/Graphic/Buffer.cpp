@@ -6,6 +6,7 @@
 //==============================================================================
 #include "Runtime.h"
 #include <deque>
+#include <vector>
 #include "Mesh.h"
 #include "Buffer.h"
 
@@ -14,6 +15,17 @@ struct DestroyBuffer { size_t counter; uint64_t device; uint64_t buffer; };
 static size_t Counter = 0;
 static std::deque<DestroyBuffer> destroyBuffers;
 //------------------------------------------------------------------------------
+struct ConstantPool { uint64_t device; int size; size_t used; std::vector<uint64_t> buffers; };
+static size_t const ConstantFrameCount = 3;
+static std::vector<ConstantPool> constantPools[ConstantFrameCount];
+static Buffer::ConstantStatistics constantStatistics;
+static size_t constantFrameBytes = 0;
+static size_t constantFrameAllocation = 0;
+//------------------------------------------------------------------------------
+struct IndexBuffer { uint64_t buffer; int count; };
+struct IndexPool { uint64_t device; int bits; size_t used; std::vector<IndexBuffer> buffers; };
+static std::vector<IndexPool> indexPools[ConstantFrameCount];
+//------------------------------------------------------------------------------
 static void (*xxDestroyBufferSystem)(uint64_t device, uint64_t buffer);
 //------------------------------------------------------------------------------
 static void xxDestroyBufferRuntime(uint64_t device, uint64_t buffer)
@@ -33,7 +45,22 @@ void Buffer::Initialize()
 //------------------------------------------------------------------------------
 void Buffer::Update()
 {
+    constantStatistics.frameBytes = constantFrameBytes;
+    constantStatistics.highWaterBytes = std::max(constantStatistics.highWaterBytes, constantFrameBytes);
+    constantStatistics.allocationCount = constantFrameAllocation;
+    constantFrameBytes = 0;
+    constantFrameAllocation = 0;
+
     Counter++;
+    for (ConstantPool& pool : constantPools[Counter % ConstantFrameCount])
+    {
+        pool.used = 0;
+    }
+    for (IndexPool& pool : indexPools[Counter % ConstantFrameCount])
+    {
+        pool.used = 0;
+    }
+
     while (destroyBuffers.empty() == false)
     {
         auto& destroyBuffer = destroyBuffers.front();
@@ -46,6 +73,33 @@ void Buffer::Update()
 //------------------------------------------------------------------------------
 void Buffer::Shutdown()
 {
+    auto destroy = xxDestroyBufferSystem ? xxDestroyBufferSystem : xxDestroyBuffer;
+    for (auto& pools : constantPools)
+    {
+        for (ConstantPool& pool : pools)
+        {
+            for (uint64_t buffer : pool.buffers)
+            {
+                destroy(pool.device, buffer);
+            }
+        }
+        pools.clear();
+    }
+    for (auto& pools : indexPools)
+    {
+        for (IndexPool& pool : pools)
+        {
+            for (IndexBuffer& buffer : pool.buffers)
+            {
+                destroy(pool.device, buffer.buffer);
+            }
+        }
+        pools.clear();
+    }
+    constantStatistics = {};
+    constantFrameBytes = 0;
+    constantFrameAllocation = 0;
+
     if (xxDestroyBufferSystem == nullptr)
         return;
     while (destroyBuffers.empty() == false)
@@ -57,4 +111,86 @@ void Buffer::Shutdown()
     xxDestroyBuffer = xxDestroyBufferSystem;
     xxDestroyBufferSystem = nullptr;
 }
+//------------------------------------------------------------------------------
+uint64_t Buffer::AllocateConstant(uint64_t device, int size)
+{
+    if (size <= 0)
+        return 0;
+
+    // Linear per frame, one pool per device and size
+    auto& pools = constantPools[Counter % ConstantFrameCount];
+    ConstantPool* pool = nullptr;
+    for (ConstantPool& candidate : pools)
+    {
+        if (candidate.device == device && candidate.size == size)
+        {
+            pool = &candidate;
+            break;
+        }
+    }
+    if (pool == nullptr)
+    {
+        pool = &pools.emplace_back(device, size, 0);
+    }
+    if (pool->used == pool->buffers.size())
+    {
+        uint64_t buffer = xxCreateConstantBuffer(device, size);
+        if (buffer == 0)
+            return 0;
+        pool->buffers.push_back(buffer);
+        constantStatistics.bufferCount++;
+    }
+
+    constantFrameBytes += size;
+    constantFrameAllocation++;
+    return pool->buffers[pool->used++];
+}
+//------------------------------------------------------------------------------
+Buffer::ConstantStatistics Buffer::GetConstantStatistics()
+{
+    return constantStatistics;
+}
+//------------------------------------------------------------------------------
+uint64_t Buffer::AllocateIndex(uint64_t device, int count, int bits)
+{
+    if (count <= 0)
+        return 0;
+
+    // Linear per frame, one pool per device and index size
+    auto& pools = indexPools[Counter % ConstantFrameCount];
+    IndexPool* pool = nullptr;
+    for (IndexPool& candidate : pools)
+    {
+        if (candidate.device == device && candidate.bits == bits)
+        {
+            pool = &candidate;
+            break;
+        }
+    }
+    if (pool == nullptr)
+    {
+        pool = &pools.emplace_back(device, bits, 0);
+    }
+    if (pool->used == pool->buffers.size())
+    {
+        pool->buffers.push_back({});
+    }
+
+    // Grow by power of two so the same slot settles after a few frames
+    IndexBuffer& index = pool->buffers[pool->used];
+    if (index.count < count)
+    {
+        int capacity = 256;
+        while (capacity < count)
+            capacity *= 2;
+        xxDestroyBuffer(device, index.buffer);
+        index.buffer = xxCreateIndexBuffer(device, capacity * bits / 8, bits);
+        index.count = index.buffer ? capacity : 0;
+        if (index.buffer == 0)
+            return 0;
+    }
+
+    pool->used++;
+    return index.buffer;
+}
 //==============================================================================
@@ -10,7 +10,22 @@
 
 struct RuntimeAPI Buffer
 {
+    struct ConstantStatistics
+    {
+        size_t frameBytes;
+        size_t highWaterBytes;
+        size_t allocationCount;
+        size_t bufferCount;
+    };
+
     static void Initialize();
     static void Update();
     static void Shutdown();
+
+    // Constant buffers live until the ring comes back to the same frame
+    static uint64_t AllocateConstant(uint64_t device, int size);
+    static ConstantStatistics GetConstantStatistics();
+
+    // Transient index buffers follow the same ring as constant buffers
+    static uint64_t AllocateIndex(uint64_t device, int count, int bits);
 };
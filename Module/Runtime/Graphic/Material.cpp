@@ -7,6 +7,7 @@
 #include "Runtime.h"
 #include <xxGraphic/internal/xxGraphicInternal.h>
 #include <xxGraphicPlus/xxTexture.h>
+#include "Buffer.h"
 #include "Camera.h"
 #include "Mesh.h"
 #include "Node.h"
@@ -32,11 +33,13 @@ struct MaterialSelector
     Language language;
     int type;
     int tab;
+    bool instance;
 
     MaterialSelector(std::string& s, Language l, int t)
         : shader(s), language(l), type(t)
     {
         tab = 0;
+        instance = false;
     }
     void Append(std::string_view string)
     {
@@ -200,15 +203,66 @@ struct MaterialSelector
         Append(string);
     }
 };
+//------------------------------------------------------------------------------
+static MaterialSelector::Language GetLanguage()
+{
+    static char const* instanceString;
+    static MaterialSelector::Language instanceLanguage;
+
+    char const* deviceString = xxGetInstanceName();
+    if (instanceString == deviceString)
+        return instanceLanguage;
+
+    MaterialSelector::Language language = MaterialSelector::GLSL;
+    if (language == 0 && strstr(deviceString, "Metal 4"))    language = MaterialSelector::MSL4;
+    if (language == 0 && strstr(deviceString, "Metal 2"))    language = MaterialSelector::MSL2;
+    if (language == 0 && strstr(deviceString, "Metal"))      language = MaterialSelector::MSL1;
+    if (language == 0 && strstr(deviceString, "Direct3D 1")) language = MaterialSelector::HLSL10;
+    if (language == 0 && strstr(deviceString, "Direct3D"))   language = MaterialSelector::HLSL;
+    if (language == 0 && strstr(deviceString, "Vulkan"))     language = MaterialSelector::HLSLVK;
+    if (language == 0 && strstr(deviceString, "GL"))         language = MaterialSelector::GLSL;
+
+    instanceString = deviceString;
+    instanceLanguage = language;
+    return language;
+}
 //==============================================================================
 //  Material
 //==============================================================================
 xxMaterialPtr Material::DefaultMaterial;
 unsigned int Material::FrameCount;
 //------------------------------------------------------------------------------
+bool Material::Instancing(xxDrawData const& data) const
+{
+    auto* mesh = data.mesh;
+    auto* node = data.node;
+
+    if (data.materialIndex == SELECT)
+        return false;
+    if (Blending || DebugMeshlet)
+        return false;
+    if (mesh->Skinning || mesh->Count[xxMesh::STORAGE0])
+        return false;
+    if (node->Flags & Node::PARTICLE)
+        return false;
+
+    // GLSL ES 1.0 and Shader Model 3 have no instance index
+    switch (GetLanguage())
+    {
+    case MaterialSelector::HLSL10:
+    case MaterialSelector::HLSLVK:
+    case MaterialSelector::MSL1:
+    case MaterialSelector::MSL2:
+    case MaterialSelector::MSL4:
+        return true;
+    default:
+        return false;
+    }
+}
+//------------------------------------------------------------------------------
 void Material::Setup(xxDrawData const& data)
 {
-    size_t materialIndex = data.materialIndex * 3 + FrameCount % 3;
+    size_t materialIndex = GetConstantIndex(data.materialIndex);
 
     auto& constantDatas = data.node->ConstantDatas;
     if (constantDatas.size() <= materialIndex)
@@ -223,6 +277,8 @@ void Material::Setup(xxDrawData const& data)
         CreateConstant(data);
         constantData->ready = (constantData->pipeline != 0) ? 1 : -1;
     }
+    if (constantData->ready <= 0)
+        return;
 
     UpdateConstant(data);
 }
@@ -245,6 +301,11 @@ void Material::Draw(xxDrawData const& data) const
         xxSetFragmentConstantBuffer(data.commandEncoder, constantData->fragmentConstant, constantData->fragmentConstantSize);
     }
 
+    // The ring owns the buffers
+    constantData->meshConstant = 0;
+    constantData->vertexConstant = 0;
+    constantData->fragmentConstant = 0;
+
     int textureCount = 0;
     uint64_t textures[16];
     uint64_t samplers[16];
@@ -376,34 +437,11 @@ void Material::CreateConstant(xxDrawData const& data) const
 {
     auto* constantData = data.constantData;
 
-    if (constantData->meshConstant == 0 && constantData->vertexConstant == 0 && constantData->fragmentConstant == 0)
-    {
-        constantData->device = data.device;
-        if (constantData->meshShader && constantData->meshConstant == 0)
-        {
-            constantData->meshConstantSize = GetMeshConstantSize(data);
-            if (constantData->meshConstantSize > 0)
-            {
-                constantData->meshConstant = xxCreateConstantBuffer(m_device, constantData->meshConstantSize);
-            }
-        }
-        if (constantData->vertexShader && constantData->vertexConstant == 0)
-        {
-            constantData->vertexConstantSize = GetVertexConstantSize(data);
-            if (constantData->vertexConstantSize > 0)
-            {
-                constantData->vertexConstant = xxCreateConstantBuffer(m_device, constantData->vertexConstantSize);
-            }
-        }
-        if (constantData->fragmentShader && constantData->fragmentConstant == 0)
-        {
-            constantData->fragmentConstantSize = GetFragmentConstantSize(data);
-            if (constantData->fragmentConstantSize > 0)
-            {
-                constantData->fragmentConstant = xxCreateConstantBuffer(m_device, constantData->fragmentConstantSize);
-            }
-        }
-    }
+    // Buffers are allocated from Buffer::AllocateConstant on every update
+    constantData->device = data.device;
+    constantData->meshConstantSize = constantData->meshShader ? std::max(GetMeshConstantSize(data), 0) : 0;
+    constantData->vertexConstantSize = constantData->vertexShader ? std::max(GetVertexConstantSize(data), 0) : 0;
+    constantData->fragmentConstantSize = constantData->fragmentShader ? std::max(GetFragmentConstantSize(data), 0) : 0;
 }
 //------------------------------------------------------------------------------
 void Material::UpdateConstant(xxDrawData const& data) const
@@ -416,9 +454,11 @@ void Material::UpdateConstant(xxDrawData const& data) const
         size = constantData->vertexConstantSize;
     if (size)
     {
-        uint64_t constant = constantData->meshConstant;
-        if (constant == 0)
-            constant = constantData->vertexConstant;
+        uint64_t constant = Buffer::AllocateConstant(m_device, size);
+        if (constantData->meshConstantSize)
+            constantData->meshConstant = constant;
+        else
+            constantData->vertexConstant = constant;
         xxVector4* vector = reinterpret_cast<xxVector4*>(xxMapBuffer(m_device, constant));
         if (vector)
         {
@@ -436,7 +476,7 @@ void Material::UpdateConstant(xxDrawData const& data) const
     size = constantData->fragmentConstantSize;
     if (size)
     {
-        uint64_t constant = constantData->fragmentConstant;
+        uint64_t constant = constantData->fragmentConstant = Buffer::AllocateConstant(m_device, size);
         xxVector4* vector = reinterpret_cast<xxVector4*>(xxMapBuffer(m_device, constant));
         if (vector)
         {
@@ -453,15 +493,7 @@ std::string Material::GetShader(xxDrawData const& data, int type) const
     auto* node = data.node;
     auto* constantData = data.constantData;
 
-    char const* deviceString = xxGetInstanceName();
-    MaterialSelector::Language language = MaterialSelector::GLSL;
-    if (language == 0 && strstr(deviceString, "Metal 4"))    language = MaterialSelector::MSL4;
-    if (language == 0 && strstr(deviceString, "Metal 2"))    language = MaterialSelector::MSL2;
-    if (language == 0 && strstr(deviceString, "Metal"))      language = MaterialSelector::MSL1;
-    if (language == 0 && strstr(deviceString, "Direct3D 1")) language = MaterialSelector::HLSL10;
-    if (language == 0 && strstr(deviceString, "Direct3D"))   language = MaterialSelector::HLSL;
-    if (language == 0 && strstr(deviceString, "Vulkan"))     language = MaterialSelector::HLSLVK;
-    if (language == 0 && strstr(deviceString, "GL"))         language = MaterialSelector::GLSL;
+    MaterialSelector::Language language = GetLanguage();
 
     std::string shader;
     int meshTextureSlot = 0;
@@ -469,6 +501,7 @@ std::string Material::GetShader(xxDrawData const& data, int type) const
     int fragmentTextureSlot = 0;
 
     struct MaterialSelector s(shader, language, type);
+    s.instance = (type == 'vert') && (data.materialIndex & INSTANCE);
 
     shader += ShaderOption;
     s.Define("DEBUG_NORMAL", DebugNormal ? 1 : 0);
@@ -498,6 +531,7 @@ std::string Material::GetShader(xxDrawData const& data, int type) const
         s.Define("SHADER_UNIFORM", GetVertexConstantSize(data) / sizeof(xxVector4));
         s.Define("SHADER_SKINNING", mesh->Skinning ? 1 : 0);
         s.Define("SHADER_PARTICLE", node->Flags & Node::PARTICLE ? 1 : 0);
+        s.Define("SHADER_INSTANCE", s.instance ? MaxInstanceCount : 0);
         s.Define("SHADER_OPACITY", Blending ? 1 : 0);
         ShaderDefault(data, s);
         ShaderAttribute(data, s);
@@ -798,16 +832,19 @@ void Material::ShaderVertex(xxDrawData const& data, struct MaterialSelector& s)
     int color = mesh->ColorCount;
     int texture = mesh->TextureCount;
     int fragNormal = (Lighting || DebugNormal) ? normal : 0;
-
-    //          GLSL           HLSL              MSL
-    s.GHM(true, "",            "",               "vertex"                                  );
-    s.GHM(true, "void main()", "Varying Main",   "Varying Main"                            );
-    s.GHM(true, "",            "(",              "("                                       );
-    s.GHM(true, "",            "Attribute attr", "Attribute attr [[stage_in]],"            );
-    s.GHM(true, "",            "",               "constant Uniform& uni [[buffer(" V ")]]" );
-    s.GHM(true, "",            ")",              ")"                                       );
-    s.GHM(true, "{",           "{",              "{"                                       );
-    s.GHM(true, "",            "",               "auto uniBuffer = uni.Buffer;"            );
+    bool instance = s.instance;
+
+    //                       GLSL           HLSL                               MSL
+    s.GHM(true,              "",            "",                                "vertex"                                  );
+    s.GHM(true,              "void main()", "Varying Main",                    "Varying Main"                            );
+    s.GHM(true,              "",            "(",                               "("                                       );
+    s.GHM(instance == false, "",            "Attribute attr",                  "Attribute attr [[stage_in]],"            );
+    s.GHM(instance,          "",            "Attribute attr,",                 "Attribute attr [[stage_in]],"            );
+    s.GHM(instance,          "",            "uint instanceID : SV_InstanceID", "uint instanceID [[instance_id]],"        );
+    s.GHM(true,              "",            "",                                "constant Uniform& uni [[buffer(" V ")]]" );
+    s.GHM(true,              "",            ")",                               ")"                                       );
+    s.GHM(true,              "{",           "{",                               "{"                                       );
+    s.GHM(true,              "",            "",                                "auto uniBuffer = uni.Buffer;"            );
 
     //                GLSL                       HLSL / MSL
     s.GH(true,        "int uniIndex = 0;",       "int uniIndex = 0;"                         );
@@ -1177,6 +1214,54 @@ void Material::UpdateTransformConstant(xxDrawData const& data, int& size, xxVect
 //------------------------------------------------------------------------------
 void Material::UpdateWorldViewProjectionConstant(xxDrawData const& data, int& size, xxVector4** pointer, struct MaterialSelector* s) const
 {
+    if (data.materialIndex & INSTANCE)
+    {
+        int const instanceSize = 2 * sizeof(xxMatrix4x4) + MaxInstanceCount * sizeof(xxMatrix4x3);
+        if (pointer == nullptr)
+        {
+            size += instanceSize;
+        }
+        if (size >= instanceSize && pointer)
+        {
+            xxMatrix4x4* vp = reinterpret_cast<xxMatrix4x4*>(*pointer);
+            xxMatrix4x3* world = reinterpret_cast<xxMatrix4x3*>(vp + 2);
+            size -= instanceSize;
+            (*pointer) += 2 * 4 + MaxInstanceCount * 3;
+
+            xxCamera* camera = data.camera;
+            if (camera)
+            {
+                vp[0] = camera->ViewMatrix;
+                vp[1] = camera->ProjectionMatrix;
+            }
+            else
+            {
+                vp[0] = xxMatrix4::IDENTITY;
+                vp[1] = xxMatrix4::IDENTITY;
+            }
+
+            auto const& instanceData = static_cast<InstanceDrawData const&>(data);
+            for (int i = 0; i < instanceData.instanceCount; ++i)
+            {
+                world[i] = xxMatrix4x3::FromMatrix4(instanceData.instanceNodes[i]->WorldMatrix);
+            }
+        }
+        if (s)
+        {
+            (*s)(true, "float4 zero4 = float4(0.0, 0.0, 0.0, 0.0);"                                                                                         );
+            (*s)(true, "int instanceIndex = uniIndex + 8 + int(instanceID) * 3;"                                                                           );
+            (*s)(true, "float4x4 world = float4x4(uniBuffer[instanceIndex], uniBuffer[instanceIndex + 1], uniBuffer[instanceIndex + 2], zero4);"           );
+            (*s)(true, "float4x4 view = float4x4(uniBuffer[uniIndex + 0], uniBuffer[uniIndex + 1], uniBuffer[uniIndex + 2], uniBuffer[uniIndex + 3]);"     );
+            (*s)(true, "float4x4 projection = float4x4(uniBuffer[uniIndex + 4], uniBuffer[uniIndex + 5], uniBuffer[uniIndex + 6], uniBuffer[uniIndex + 7]);" );
+            (*s)(true, "world[3][3] = 1.0;"                                                                                                                 );
+            (*s)(true, "uniIndex += 8 + SHADER_INSTANCE * 3;"                                                                                               );
+
+            (*s).GHM(true, "",                                    "world = transpose(world);", ""                                    );
+            (*s).GHM(true, "view = transpose(view);",             "",                          "view = transpose(view);"             );
+            (*s).GHM(true, "projection = transpose(projection);", "",                          "projection = transpose(projection);" );
+        }
+        return;
+    }
     if (pointer == nullptr)
     {
         size += 3 * sizeof(xxMatrix4x4);
@@ -1213,6 +1298,11 @@ void Material::UpdateWorldViewProjectionConstant(xxDrawData const& data, int& si
     }
 }
 //------------------------------------------------------------------------------
+size_t Material::GetConstantIndex(int materialIndex)
+{
+    return (materialIndex & ~INSTANCE) * 2 + (materialIndex & INSTANCE ? 1 : 0);
+}
+//------------------------------------------------------------------------------
 static xxMaterialPtr (*backupBinaryCreate)();
 //------------------------------------------------------------------------------
 void Material::Initialize()
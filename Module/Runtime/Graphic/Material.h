@@ -17,6 +17,7 @@ public:
         DEFAULT             = 0,
         SHADOW              = 1,
         SELECT              = 2,
+        INSTANCE            = 0b10000000,
     };
 
     enum TextureType
@@ -25,7 +26,15 @@ public:
         BUMP                = 1,
     };
 
+    struct InstanceDrawData : public xxDrawData
+    {
+        Node* const*        instanceNodes = nullptr;
+        int                 instanceCount = 0;
+    };
+
 public:
+    bool                    Instancing(xxDrawData const& data) const;
+
     void                    Setup(xxDrawData const& data) override;
     void                    Draw(xxDrawData const& data) const override;
 
@@ -67,6 +76,9 @@ public:
 
     static xxMaterialPtr    DefaultMaterial;
     static unsigned int     FrameCount;
+    static int const        MaxInstanceCount = 64;
+
+    static size_t           GetConstantIndex(int materialIndex);
 
     static void             Initialize();
     static void             Shutdown();
@@ -5,6 +5,8 @@
 // https://github.com/NyankoLab/Minamoto
 //==============================================================================
 #include "Runtime.h"
+#include "Binary.h"
+#include "Buffer.h"
 #include "Mesh.h"
 
 //==============================================================================
@@ -15,6 +17,14 @@ Mesh::Mesh(bool skinning, char normal, char color, char texture)
 //------------------------------------------------------------------------------
 Mesh::~Mesh()
 {
+    // Arrays lent by a mapped file are not owned by xxMesh
+    for (int i = 0; i < BUFFERMAX; ++i)
+    {
+        if (m_mapped[i])
+        {
+            const_cast<char*&>(Storage[i]) = nullptr;
+        }
+    }
 }
 //------------------------------------------------------------------------------
 void Mesh::Invalidate()
@@ -100,8 +110,104 @@ void Mesh::Draw(uint64_t commandEncoder, int instanceCount, int firstIndex, int
     }
 }
 //------------------------------------------------------------------------------
+void Mesh::DrawMeshlet(uint64_t commandEncoder, xxMatrix4 const& world, xxMatrix4x2 const* frustum, bool backfaceCulling, bool frustumCulling)
+{
+    // Same layout as MeshTools::CreateMeshlet
+    struct MeshletStorage
+    {
+        uint32_t vertex_offset;
+        uint32_t triangle_offset;
+        uint32_t vertex_count;
+        uint32_t triangle_count;
+        xxVector4 center_radius;
+        xxVector4 cone_apex;
+        xxVector4 cone_axis_cutoff;
+    };
+    static_assert(sizeof(MeshletStorage) == 64);
+
+    MeshletVisible = 0;
+    if (Count[VERTEX] == 0 || Count[STORAGE0] == 0)
+        return;
+
+    // Every draw takes its own index buffer from the frame ring, earlier ones may still be in flight
+    int bits = Count[VERTEX] < 65536 ? 16 : 32;
+    uint64_t buffer = Buffer::AllocateIndex(m_device, Count[STORAGE2] * 3, bits);
+    if (buffer == 0)
+        return;
+    void* map = xxMapBuffer(m_device, buffer);
+    if (map == nullptr)
+        return;
+
+    if (frustum == nullptr)
+    {
+        backfaceCulling = false;
+        frustumCulling = false;
+    }
+    xxVector3 eye = frustum ? frustum[0][1].xyz : xxVector3::ZERO;
+
+    auto* meshlets = reinterpret_cast<MeshletStorage*>(Storage[STORAGE0]);
+    auto* vertices = reinterpret_cast<uint32_t*>(Storage[STORAGE1]);
+    auto* triangles = reinterpret_cast<uint32_t*>(Storage[STORAGE2]);
+    auto compact = [&](auto* indices)
+    {
+        int count = 0;
+        for (int i = 0; i < Count[STORAGE0]; ++i)
+        {
+            MeshletStorage const& meshlet = meshlets[i];
+            if (backfaceCulling)
+            {
+                xxVector4 const& apex = meshlet.cone_apex;
+                xxVector4 const& axis = meshlet.cone_axis_cutoff;
+                xxVector3 worldApex = world.v[0].xyz * apex.x + world.v[1].xyz * apex.y + world.v[2].xyz * apex.z + world.v[3].xyz;
+                xxVector3 worldAxis = world.v[0].xyz * axis.x + world.v[1].xyz * axis.y + world.v[2].xyz * axis.z;
+                xxVector3 direction = worldApex - eye;
+                float length = worldAxis.Length() * direction.Length();
+                if (length > 0.0f && worldAxis.Dot(direction) >= axis.w * length)
+                    continue;
+            }
+            if (frustumCulling)
+            {
+                xxVector4 bound = meshlet.center_radius.BoundTransform(world);
+                bool outside = false;
+                for (int j = 0; j < 6; ++j)
+                {
+                    float direction = frustum[j][0].xyz.Dot(bound.xyz - frustum[j][1].xyz);
+                    if (direction < -bound.radius)
+                    {
+                        outside = true;
+                        break;
+                    }
+                }
+                if (outside)
+                    continue;
+            }
+            MeshletVisible++;
+
+            uint32_t const* local = vertices + meshlet.vertex_offset;
+            uint32_t const* packed = triangles + meshlet.triangle_offset;
+            for (uint32_t j = 0; j < meshlet.triangle_count; ++j)
+            {
+                uint32_t triangle = packed[j];
+                indices[count + 0] = local[(triangle >>  0) & 0xFF];
+                indices[count + 1] = local[(triangle >>  8) & 0xFF];
+                indices[count + 2] = local[(triangle >> 16) & 0xFF];
+                count += 3;
+            }
+        }
+        return count;
+    };
+    int count = (bits == 16) ? compact(reinterpret_cast<uint16_t*>(map)) : compact(reinterpret_cast<uint32_t*>(map));
+    xxUnmapBuffer(m_device, buffer);
+    if (count == 0)
+        return;
+
+    xxSetVertexBuffers(commandEncoder, 1, &m_buffers[VERTEX][m_bufferIndex[VERTEX]], m_vertexAttribute);
+    xxDrawIndexed(commandEncoder, buffer, count, ActiveCount[VERTEX], 1, 0, 0, 0);
+}
+//------------------------------------------------------------------------------
 void Mesh::SetIndexCount(int count)
 {
+    Materialize();
     xxMesh::SetIndexCount(count);
     ActiveCount[INDEX] = count;
 }
@@ -117,16 +223,40 @@ void Mesh::SetVertexCount(int count)
         const_cast<int&>(Stride[VERTEX]) += xxSizeOf(uint32_t) * ColorCount;
         const_cast<int&>(Stride[VERTEX]) += xxSizeOf(xxVector2) * TextureCount;
     }
+    Materialize();
     xxMesh::SetVertexCount(count);
     ActiveCount[VERTEX] = count;
 }
 //------------------------------------------------------------------------------
 void Mesh::SetStorageCount(int index, int count, int stride)
 {
+    Materialize();
     xxMesh::SetStorageCount(index, count, stride);
     ActiveCount[index] = count;
 }
 //------------------------------------------------------------------------------
+void Mesh::Materialize()
+{
+    if (m_mapping == nullptr)
+        return;
+
+    // Copy lent arrays before xxMesh reallocates them
+    for (int i = 0; i < BUFFERMAX; ++i)
+    {
+        if (m_mapped[i] == false)
+            continue;
+        size_t size = size_t(Count[i]) * Stride[i];
+        char* storage = xxAlloc(char, size);
+        if (storage)
+        {
+            memcpy(storage, Storage[i], size);
+        }
+        const_cast<char*&>(Storage[i]) = storage;
+        m_mapped[i] = false;
+    }
+    m_mapping = nullptr;
+}
+//------------------------------------------------------------------------------
 xxStrideIterator<uint32_t> Mesh::GetNormal(int index) const
 {
     char* vertex = Storage[VERTEX];
@@ -178,7 +308,10 @@ unsigned int Mesh::GetIndex(int index) const
 //------------------------------------------------------------------------------
 void Mesh::BinaryRead(xxBinary& binary)
 {
+    Materialize();
+
     xxMesh::BinaryRead(binary);
+
     for (int i = STORAGE0; i < BUFFERMAX; ++i)
     {
         ActiveCount[i] = Count[i];
@@ -249,6 +382,23 @@ void Mesh::BinaryRead(xxBinary& binary)
     }
 }
 //------------------------------------------------------------------------------
+void Mesh::Lend(Binary const& binary)
+{
+    // Swap the copies for the mapped bytes they were read from, a shared mesh is lent once
+    for (int i = 0; i < BUFFERMAX; ++i)
+    {
+        if (m_mapped[i] || Storage[i] == nullptr)
+            continue;
+        void const* pointer = binary.Lend(Storage[i], size_t(Count[i]) * Stride[i], 16);
+        if (pointer == nullptr)
+            continue;
+        xxFree(Storage[i]);
+        const_cast<char*&>(Storage[i]) = (char*)pointer;
+        m_mapped[i] = true;
+        m_mapping = binary.Mapping();
+    }
+}
+//------------------------------------------------------------------------------
 static xxMeshPtr (*backupBinaryCreate)();
 //------------------------------------------------------------------------------
 void Mesh::Initialize()
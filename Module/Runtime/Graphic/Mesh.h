@@ -9,12 +9,15 @@
 #include "Runtime.h"
 #include <xxGraphicPlus/xxMesh.h>
 
+class Binary;
+
 struct RuntimeAPI Mesh : public xxMesh
 {
 public:
     void                        Invalidate();
     void                        Setup(uint64_t device);
     void                        Draw(uint64_t commandEncoder, int instanceCount = 1, int firstIndex = 0, int vertexOffset = 0, int firstInstance = 0);
+    void                        DrawMeshlet(uint64_t commandEncoder, xxMatrix4 const& world, xxMatrix4x2 const* frustum, bool backfaceCulling, bool frustumCulling);
 
     void                        SetIndexCount(int count);
     void                        SetVertexCount(int count);
@@ -27,13 +30,20 @@ public:
     unsigned int                GetIndex(int index) const;
 
     void                        BinaryRead(xxBinary& binary) override;
+    void                        Lend(Binary const& binary);
 
 protected:
     Mesh(bool skinning, char normal, char color, char texture);
     virtual ~Mesh();
 
+    void                        Materialize();
+
+    std::shared_ptr<void>       m_mapping;
+    bool                        m_mapped[BUFFERMAX] = {};
+
 public:
     int                         ActiveCount[BUFFERMAX] = {};
+    int                         MeshletVisible = 0;
 
 public:
     static void                 Initialize();
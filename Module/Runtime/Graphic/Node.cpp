@@ -5,6 +5,7 @@
 // https://github.com/NyankoLab/Minamoto
 //==============================================================================
 #include "Runtime.h"
+#include <unordered_map>
 #include "Material.h"
 #include "Mesh.h"
 #include "Node.h"
@@ -17,23 +18,204 @@ extern "C" bool _ZN6xxNode11AttachChildERKNSt3__110shared_ptrIS_EE(Node* thiz, x
 extern "C" bool _ZN6xxNode11DetachChildERKNSt3__110shared_ptrIS_EE(Node* thiz, xxNodePtr const& child);
 extern "C" bool _ZN6xxNode9TraversalERKNSt3__110shared_ptrIS_EERKNS0_8functionIFiS4_EEE(xxNodePtr const& node, std::function<int(xxNodePtr const&)> const& callback);
 #endif
+//==============================================================================
+//  Node name index
+//==============================================================================
+struct NodeIndex
+{
+    std::unordered_multimap<std::string, xxNodeWeakPtr> names;
+};
+//------------------------------------------------------------------------------
+struct NodeLinear
+{
+    std::vector<Node::Linear> array;
+    bool dirty = true;
+};
+//------------------------------------------------------------------------------
+static void InsertName(NodeIndex& index, xxNodePtr const& node)
+{
+    Node::Traversal(node, [&](xxNodePtr const& node)
+    {
+        index.names.emplace(node->Name, node);
+        return true;
+    });
+}
+//------------------------------------------------------------------------------
+static void RemoveName(NodeIndex& index, Node* node, std::string const& name)
+{
+    auto [begin, end] = index.names.equal_range(name);
+    for (auto it = begin; it != end; ++it)
+    {
+        if (it->second.lock().get() == node)
+        {
+            index.names.erase(it);
+            break;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+static xxNodePtr FindName(xxNodePtr const& node, std::string const& name)
+{
+    xxNodePtr output;
+    Node::Traversal(node, [&](xxNodePtr const& node)
+    {
+        if (node->Name == name)
+            output = node;
+        return output ? -1 : 1;
+    });
+    return output;
+}
+//------------------------------------------------------------------------------
+Node::~Node()
+{
+}
+//------------------------------------------------------------------------------
+NodeIndex* Node::GetNameIndex() const
+{
+    Node const* root = this;
+    while (root->GetParent())
+        root = root->GetParent().get();
+    return root->m_nameIndex.get();
+}
+//------------------------------------------------------------------------------
+void Node::SetName(std::string const& name)
+{
+    NodeIndex* index = GetNameIndex();
+    if (index)
+        RemoveName(*index, this, Name);
+    Name = name;
+    if (index)
+        index->names.emplace(Name, m_this);
+}
+//------------------------------------------------------------------------------
+xxNodePtr Node::FindObject(std::string const& name)
+{
+    xxNodePtr self = m_this.lock();
+
+    // The topmost root owns the index, it is built on the first lookup
+    Node* root = this;
+    while (root->GetParent())
+        root = root->GetParent().get();
+    if (root->m_nameIndex == nullptr)
+    {
+        root->m_nameIndex = std::make_unique<NodeIndex>();
+        InsertName(*root->m_nameIndex, root->m_this.lock());
+    }
+    NodeIndex& index = *root->m_nameIndex;
+
+    // Drop entries left behind by nodes renamed without SetName or moved without this root,
+    // a subtree only keeps the candidates below itself
+    xxNodePtr output;
+    size_t count = 0;
+    auto [begin, end] = index.names.equal_range(name);
+    for (auto it = begin; it != end;)
+    {
+        xxNodePtr node = it->second.lock();
+        bool inside = false;
+        Node const* top = node.get();
+        while (top)
+        {
+            inside |= (top == this);
+            if (top->GetParent() == nullptr)
+                break;
+            top = top->GetParent().get();
+        }
+        if (top != root || node->Name != name)
+        {
+            it = index.names.erase(it);
+            continue;
+        }
+        if (inside)
+        {
+            output = node;
+            count++;
+        }
+        ++it;
+    }
+
+    // Duplicated names keep the first match in depth-first order, a miss may be a stale rename
+    if (count == 1)
+        return output;
+    output = FindName(self, name);
+    if (output && count == 0)
+        index.names.emplace(name, output);
+    return output;
+}
+//------------------------------------------------------------------------------
+void Node::SetRotate(xxMatrix3 const& rotate)
+{
+    xxNode::SetRotate(rotate);
+    Flags |= UPDATE_DIRTY;
+}
+//------------------------------------------------------------------------------
+void Node::SetScale(float scale)
+{
+    xxNode::SetScale(scale);
+    Flags |= UPDATE_DIRTY;
+}
+//------------------------------------------------------------------------------
+void Node::SetTranslate(xxVector3 const& translate)
+{
+    xxNode::SetTranslate(translate);
+    Flags |= UPDATE_DIRTY;
+}
 //------------------------------------------------------------------------------
 bool Node::AttachChild(xxNodePtr const& child)
 {
+    if (child && child->GetParent())
+        child->GetParent()->UpdateTopology();
 #if defined(xxMACOS) || defined(xxIOS)
-    return _ZN6xxNode11AttachChildERKNSt3__110shared_ptrIS_EE(this, child);
+    bool attach = _ZN6xxNode11AttachChildERKNSt3__110shared_ptrIS_EE(this, child);
 #else
-    return xxNode::AttachChild(child);
+    bool attach = xxNode::AttachChild(child);
 #endif
+    if (attach)
+    {
+        UpdateTopology();
+        child->Flags |= UPDATE_DIRTY;
+        child->m_nameIndex = nullptr;
+        if (NodeIndex* index = GetNameIndex())
+            InsertName(*index, child);
+    }
+    return attach;
 }
 //------------------------------------------------------------------------------
 bool Node::DetachChild(xxNodePtr const& child)
 {
+    NodeIndex* index = child && child->GetParent().get() == this ? GetNameIndex() : nullptr;
 #if defined(xxMACOS) || defined(xxIOS)
-    return _ZN6xxNode11DetachChildERKNSt3__110shared_ptrIS_EE(this, child);
+    bool detach = _ZN6xxNode11DetachChildERKNSt3__110shared_ptrIS_EE(this, child);
 #else
-    return xxNode::DetachChild(child);
+    bool detach = xxNode::DetachChild(child);
 #endif
+    if (detach)
+        UpdateTopology();
+    if (detach && index)
+    {
+        Traversal(child, [&](xxNodePtr const& node)
+        {
+            RemoveName(*index, node.get(), node->Name);
+            return true;
+        });
+    }
+    return detach;
+}
+//------------------------------------------------------------------------------
+void Node::RemoveAllChildren()
+{
+    if (NodeIndex* index = GetNameIndex())
+    {
+        for (xxNodePtr const& child : (*this))
+        {
+            Traversal(child, [&](xxNodePtr const& node)
+            {
+                RemoveName(*index, node.get(), node->Name);
+                return true;
+            });
+        }
+    }
+    xxNode::RemoveAllChildren();
+    UpdateTopology();
 }
 //------------------------------------------------------------------------------
 void Node::Invalidate()
@@ -68,6 +250,13 @@ void Node::Draw(xxDrawData const& data)
         return;
 
     material->Draw(data);
+
+    // Backends without mesh shader cull meshlets on CPU
+    if (data.constantData->meshShader == 0 && Mesh->Count[xxMesh::STORAGE0])
+    {
+        Mesh->DrawMeshlet(data.commandEncoder, WorldMatrix, data.frustum, material->BackfaceCulling, material->FrustumCulling);
+        return;
+    }
     Mesh->Draw(data.commandEncoder);
 }
 //------------------------------------------------------------------------------
@@ -79,6 +268,47 @@ bool Node::Traversal(xxNodePtr const& node, std::function<int(xxNodePtr const&)>
     return xxNode::Traversal(node, callback);
 #endif
 }
+//------------------------------------------------------------------------------
+static void FlattenNode(std::vector<Node::Linear>& array, Node* node, uint32_t parent)
+{
+    uint32_t index = uint32_t(array.size());
+    array.push_back({ node, parent, 0 });
+    for (xxNodePtr const& child : (*node))
+    {
+        FlattenNode(array, child.get(), index);
+    }
+    array[index].next = uint32_t(array.size());
+}
+//------------------------------------------------------------------------------
+std::vector<Node::Linear> const& Node::Flatten(Node* node)
+{
+    if (node == nullptr)
+    {
+        static std::vector<Linear> empty;
+        return empty;
+    }
+    if (node->m_linear == nullptr)
+    {
+        node->m_linear = std::make_unique<NodeLinear>();
+    }
+    NodeLinear& linear = *node->m_linear;
+    if (linear.dirty)
+    {
+        linear.array.clear();
+        FlattenNode(linear.array, node, UINT32_MAX);
+        linear.dirty = false;
+    }
+    return linear.array;
+}
+//------------------------------------------------------------------------------
+void Node::UpdateTopology()
+{
+    for (Node* node = this; node; node = node->GetParent().get())
+    {
+        if (node->m_linear)
+            node->m_linear->dirty = true;
+    }
+}
 //==============================================================================
 //  Node
 //==============================================================================
@@ -14,22 +14,72 @@ struct RuntimeAPI Node : public xxNode
 public:
     enum
     {
-        PARTICLE    = 0b00000001'00000000,
+        PARTICLE        = 0b00000001'00000000,
+        UPDATE_DIRTY    = 0b00000010'00000000,
+    };
+
+    struct Linear
+    {
+        Node*       node;
+        uint32_t    parent;
+        uint32_t    next;
     };
 
 public:
     bool        AttachChild(xxNodePtr const& child);
     bool        DetachChild(xxNodePtr const& child);
+    void        RemoveAllChildren();
+
+    // Renaming through SetName keeps the name index of the root up to date
+    void        SetName(std::string const& name);
+    xxNodePtr   FindObject(std::string const& name);
+
+    // The setters mark the node dirty for NodeTools::Update, direct writes to LocalMatrix set UPDATE_DIRTY
+    void        SetRotate(xxMatrix3 const& rotate);
+    void        SetScale(float scale);
+    void        SetTranslate(xxVector3 const& translate);
 
     void        Invalidate();
     void        Draw(xxDrawData const& data);
 
     static bool Traversal(xxNodePtr const& node, std::function<int(xxNodePtr const&)> const& callback);
 
+    // Depth-first array of the subtree, rebuilt after the topology below the node changes
+    static std::vector<Linear> const& Flatten(Node* node);
+
+    // Same result as Traversal, the callback must not change the topology
+    template<class F>
+    static bool Visit(xxNodePtr const& node, F&& callback);
+
     static void Initialize();
     static void Shutdown();
+
+protected:
+    ~Node();
+
+    struct NodeIndex*   GetNameIndex() const;
+    void                UpdateTopology();
+
+    std::unique_ptr<struct NodeIndex> m_nameIndex;
+    std::unique_ptr<struct NodeLinear> m_linear;
 };
 
+//------------------------------------------------------------------------------
+template<class F>
+bool Node::Visit(xxNodePtr const& node, F&& callback)
+{
+    std::vector<Linear> const& array = Flatten(node.get());
+    size_t count = array.size();
+    for (size_t i = 0; i < count;)
+    {
+        int result = callback(array[i].node);
+        if (result < 0)
+            return false;
+        i = result ? i + 1 : array[i].next;
+    }
+    return true;
+}
+
 #if defined(xxWINDOWS)
 #if defined(_LIBCPP_VERSION)
 #pragma comment(linker, "/alternatename:__imp_?AttachChild@xxNode@@QEAA_NAEBV?$shared_ptr@UNode@@@__1@std@@@Z=__imp_?AttachChild@xxNode@@QEAA_NAEBV?$shared_ptr@VxxNode@@@__1@std@@@Z")
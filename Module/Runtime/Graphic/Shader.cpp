@@ -5,70 +5,134 @@
 // https://github.com/NyankoLab/Minamoto
 //==============================================================================
 #include "Runtime.h"
+#include <xxGraphicPlus/xxFile.h>
 #include <map>
-#include <string_view>
+#include <set>
+#include <unordered_map>
 #include "Shader.h"
 
+#define TAG "Shader"
+
 //==============================================================================
 static uint64_t defaultDevice;
-static std::map<size_t, uint64_t> meshShaders;
-static std::map<size_t, uint64_t> vertexShaders;
-static std::map<size_t, uint64_t> fragmentShaders;
+static std::map<uint64_t, uint64_t> meshShaders;
+static std::map<uint64_t, uint64_t> vertexShaders;
+static std::map<uint64_t, uint64_t> fragmentShaders;
+static std::unordered_map<uint64_t, std::string> cacheBlobs;
+static std::set<std::string> rejectedBackends;
+static bool cacheDirty;
+//------------------------------------------------------------------------------
+std::string Shader::CachePath;
+size_t Shader::CacheHit;
+size_t Shader::CacheMiss;
+std::string (*Shader::Compile)(char const* backend, char const* shader, int type);
+uint64_t (*Shader::Create)(uint64_t device, void const* blob, size_t size, int type, uint64_t vertexAttribute);
+//------------------------------------------------------------------------------
+struct CacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+};
+static_assert(sizeof(CacheHeader) == 16);
 //------------------------------------------------------------------------------
 static uint64_t (*xxCreateMeshShaderSystem)(uint64_t device, char const* shader);
 static uint64_t (*xxCreateVertexShaderSystem)(uint64_t device, char const* shader, uint64_t vertexAttribute);
 static uint64_t (*xxCreateFragmentShaderSystem)(uint64_t device, char const* shader);
 static void     (*xxDestroyShaderSystem)(uint64_t device, uint64_t shader);
 //------------------------------------------------------------------------------
-static uint64_t xxCreateMeshShaderRuntime(uint64_t device, char const* shader)
+template<class T>
+static uint64_t CreateShader(std::map<uint64_t, uint64_t>& shaders, uint64_t device, char const* shader, int type, uint64_t vertexAttribute, T create)
 {
-    size_t hash = std::hash<std::string_view>()(shader);
-    auto it = meshShaders.find(hash);
-    if (it != meshShaders.end())
+    char const* backend = xxGetInstanceName();
+    uint64_t hash = Shader::Hash(backend, shader, type);
+    auto it = shaders.find(hash);
+    if (it != shaders.end())
     {
         return (*it).second;
     }
-    uint64_t output = xxCreateMeshShaderSystem(device, shader);
+
+    // The cache stays inactive unless both sides of the blob path are installed
+    bool cache = Shader::Compile && Shader::Create && rejectedBackends.count(backend) == 0;
+
+    // Hit : the cached blob goes to the backend with its size, without compiling
+    uint64_t output = 0;
+    auto blob = cache ? cacheBlobs.find(hash) : cacheBlobs.end();
+    if (blob != cacheBlobs.end())
+    {
+        output = Shader::Create(device, (*blob).second.data(), (*blob).second.size(), type, vertexAttribute);
+        if (output != 0)
+        {
+            Shader::CacheHit++;
+        }
+        else
+        {
+            xxLog(TAG, "Cache is rejected : %016llX", (unsigned long long)hash);
+            cacheBlobs.erase(blob);
+            cacheDirty = true;
+        }
+    }
+
+    // Miss : compile once and keep the blob when the backend accepts it
+    if (output == 0)
+    {
+        Shader::CacheMiss++;
+        std::string compiled;
+        if (cache)
+        {
+            compiled = Shader::Compile(backend, shader, type);
+        }
+        if (compiled.empty() == false)
+        {
+            output = Shader::Create(device, compiled.data(), compiled.size(), type, vertexAttribute);
+            if (output != 0)
+            {
+                cacheBlobs[hash] = std::move(compiled);
+                cacheDirty = true;
+            }
+        }
+        if (output == 0)
+        {
+            output = create(shader);
+            if (output != 0 && compiled.empty() == false)
+            {
+                xxLog(TAG, "%s does not accept compiled shaders", backend);
+                rejectedBackends.insert(backend);
+            }
+        }
+    }
+
     if (output != 0)
     {
         defaultDevice = device;
-        meshShaders.insert(it, {hash, output});
+        shaders.emplace(hash, output);
     }
     return output;
 }
 //------------------------------------------------------------------------------
-static uint64_t xxCreateVertexShaderRuntime(uint64_t device, char const* shader, uint64_t vertexAttribute)
+static uint64_t xxCreateMeshShaderRuntime(uint64_t device, char const* shader)
 {
-    size_t hash = std::hash<std::string_view>()(shader);
-    auto it = vertexShaders.find(hash);
-    if (it != vertexShaders.end())
+    return CreateShader(meshShaders, device, shader, 'mesh', 0, [&](char const* source)
     {
-        return (*it).second;
-    }
-    uint64_t output = xxCreateVertexShaderSystem(device, shader, vertexAttribute);
-    if (output != 0)
+        return xxCreateMeshShaderSystem(device, source);
+    });
+}
+//------------------------------------------------------------------------------
+static uint64_t xxCreateVertexShaderRuntime(uint64_t device, char const* shader, uint64_t vertexAttribute)
+{
+    return CreateShader(vertexShaders, device, shader, 'vert', vertexAttribute, [&](char const* source)
     {
-        defaultDevice = device;
-        vertexShaders.insert(it, {hash, output});
-    }
-    return output;
+        return xxCreateVertexShaderSystem(device, source, vertexAttribute);
+    });
 }
 //------------------------------------------------------------------------------
 static uint64_t xxCreateFragmentShaderRuntime(uint64_t device, char const* shader)
 {
-    size_t hash = std::hash<std::string_view>()(shader);
-    auto it = fragmentShaders.find(hash);
-    if (it != fragmentShaders.end())
-    {
-        return (*it).second;
-    }
-    uint64_t output = xxCreateFragmentShaderSystem(device, shader);
-    if (output != 0)
+    return CreateShader(fragmentShaders, device, shader, 'frag', 0, [&](char const* source)
     {
-        defaultDevice = device;
-        fragmentShaders.insert(it, {hash, output});
-    }
-    return output;
+        return xxCreateFragmentShaderSystem(device, source);
+    });
 }
 //------------------------------------------------------------------------------
 static void xxDestroyShaderRuntime(uint64_t device, uint64_t shader)
@@ -79,6 +143,11 @@ void Shader::Initialize()
 {
     if (xxCreateMeshShaderSystem)
         return;
+    if (CachePath.empty() == false && cacheBlobs.empty())
+    {
+        LoadCache(CachePath.c_str());
+    }
+    rejectedBackends.clear();
     xxCreateMeshShaderSystem = xxCreateMeshShader;
     xxCreateVertexShaderSystem = xxCreateVertexShader;
     xxCreateFragmentShaderSystem = xxCreateFragmentShader;
@@ -93,6 +162,10 @@ void Shader::Shutdown()
 {
     if (xxCreateMeshShaderSystem == nullptr)
         return;
+    if (CachePath.empty() == false && cacheDirty)
+    {
+        SaveCache(CachePath.c_str());
+    }
     for (auto const& [hash, shader] : meshShaders)
         xxDestroyShaderSystem(defaultDevice, shader);
     for (auto const& [hash, shader] : vertexShaders)
@@ -112,4 +185,112 @@ void Shader::Shutdown()
     xxCreateFragmentShaderSystem = nullptr;
     xxDestroyShaderSystem = nullptr;
 }
+//------------------------------------------------------------------------------
+uint64_t Shader::Hash(char const* backend, char const* shader, int type)
+{
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto fnv = [&hash](char const* data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= uint8_t(data[i]);
+            hash *= 0x100000001B3ull;
+        }
+    };
+    char bytes[4] = { char(type >> 24), char(type >> 16), char(type >> 8), char(type) };
+    fnv(bytes, 4);
+    fnv(backend, strlen(backend) + 1);
+    fnv(shader, strlen(shader));
+    return hash;
+}
+//------------------------------------------------------------------------------
+bool Shader::LoadCache(char const* name)
+{
+    bool succeed = false;
+
+    xxFile* file = xxFile::Load(name);
+    xxLocalBreak()
+    {
+        if (file == nullptr)
+            break;
+        CacheHeader header;
+        if (file->Read(&header, sizeof(CacheHeader)) != sizeof(CacheHeader))
+            break;
+        if (header.magic != "SHDC"_cc || header.version != CacheVersion)
+        {
+            xxLog(TAG, "Cache is outdated : %s", xxFile::GetName(name, true).c_str());
+            break;
+        }
+        std::unordered_map<uint64_t, std::string> blobs;
+        uint32_t index = 0;
+        for (index = 0; index < header.count; ++index)
+        {
+            uint64_t hash = 0;
+            uint32_t size = 0;
+            if (file->Read(&hash, sizeof(hash)) != sizeof(hash))
+                break;
+            if (file->Read(&size, sizeof(size)) != sizeof(size))
+                break;
+            std::string blob(size, 0);
+            if (file->Read(blob.data(), size) != size)
+                break;
+            blobs.emplace(hash, std::move(blob));
+        }
+        if (index != header.count)
+            break;
+        for (auto& [hash, blob] : blobs)
+            cacheBlobs.emplace(hash, std::move(blob));
+        xxLog(TAG, "Cache : %s (%zu)", xxFile::GetName(name, true).c_str(), blobs.size());
+        succeed = true;
+    }
+    delete file;
+
+    return succeed;
+}
+//------------------------------------------------------------------------------
+bool Shader::SaveCache(char const* name)
+{
+    bool succeed = false;
+
+    xxFile* file = xxFile::Save(name);
+    xxLocalBreak()
+    {
+        if (file == nullptr)
+            break;
+        CacheHeader header = {};
+        header.magic = "SHDC"_cc;
+        header.version = CacheVersion;
+        header.count = uint32_t(cacheBlobs.size());
+        if (file->Write(&header, sizeof(CacheHeader)) != sizeof(CacheHeader))
+            break;
+        uint32_t index = 0;
+        for (auto const& [hash, blob] : cacheBlobs)
+        {
+            uint32_t size = uint32_t(blob.size());
+            if (file->Write(&hash, sizeof(hash)) != sizeof(hash))
+                break;
+            if (file->Write(&size, sizeof(size)) != sizeof(size))
+                break;
+            if (file->Write(blob.data(), size) != size)
+                break;
+            index++;
+        }
+        if (index != header.count)
+            break;
+        cacheDirty = false;
+        succeed = true;
+    }
+    delete file;
+
+    return succeed;
+}
+//------------------------------------------------------------------------------
+void Shader::ClearCache()
+{
+    cacheBlobs.clear();
+    cacheDirty = false;
+    CacheHit = 0;
+    CacheMiss = 0;
+}
 //==============================================================================
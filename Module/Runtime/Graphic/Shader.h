@@ -12,4 +12,21 @@ struct RuntimeAPI Shader
 {
     static void Initialize();
     static void Shutdown();
+
+    static uint64_t Hash(char const* backend, char const* shader, int type);
+    static bool LoadCache(char const* name);
+    static bool SaveCache(char const* name);
+    static void ClearCache();
+
+    static std::string CachePath;
+    static size_t CacheHit;
+    static size_t CacheMiss;
+
+    // Both hooks are needed for the cache, the stock backends only take source text
+    // Compile returns the blob of the text the backend would compile, empty keeps the source
+    // Create builds a shader from the blob and its size, 0 falls back to the source
+    static std::string (*Compile)(char const* backend, char const* shader, int type);
+    static uint64_t (*Create)(uint64_t device, void const* blob, size_t size, int type, uint64_t vertexAttribute);
+
+    static constexpr uint32_t CacheVersion = 0x20261018;
 };
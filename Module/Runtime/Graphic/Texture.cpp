@@ -6,7 +6,11 @@
 //==============================================================================
 #include "Runtime.h"
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <xxGraphicPlus/xxFile.h>
 #include <xxGraphicPlus/xxTexture.h>
 #include "Texture.h"
@@ -35,8 +39,172 @@
 #define TAG "Texture"
 
 //==============================================================================
+static int const STREAM_TAIL = 64;
+//------------------------------------------------------------------------------
+struct StreamState
+{
+    xxTextureWeakPtr texture;
+    uint64_t generation;    // Unique per registration, addresses can be reused
+    std::string filename;
+    size_t offset;          // First mipmap in the file
+    uint64_t format;
+    int width;
+    int height;
+    int depth;
+    int mipmap;
+    int tail;               // Coarsest level kept when evicted
+    int resident;           // Finest level in memory
+    int requested;          // Finest level drawn in this frame
+    int loading;            // Level in the loader, mipmap when idle
+    unsigned int frame;     // Last frame requested
+};
+struct StreamJob
+{
+    xxTexture* key;
+    uint64_t generation;
+    std::string filename;
+    size_t offset;
+    uint64_t format;
+    int width;
+    int height;
+    int depth;
+    int mipmap;
+    int level;
+    std::vector<char> data;
+};
+//------------------------------------------------------------------------------
 static std::map<std::string, xxTexturePtr> textures;
+static std::map<xxTexture*, StreamState> streams;
+static std::deque<StreamJob> streamJobs;
+static std::deque<StreamJob> streamResults;
+static std::mutex streamMutex;
+static std::condition_variable streamCondition;
+static std::thread streamThread;
+static bool streamRunning;
+static size_t streamBudget;
+static unsigned int streamFrame;
+static uint64_t streamGeneration;
+static Texture::StreamingStatistics streamStatistics;
+//------------------------------------------------------------------------------
+static std::string LowerName(std::string const& text)
+{
+    std::string name;
+    name.reserve(text.size());
+    for (char c : text)
+    {
+        if (c >= 'A' && c <= 'Z')
+            c = c + ('a' - 'A');
+        name.push_back(c);
+    }
+    return name;
+}
+//------------------------------------------------------------------------------
+static size_t MipmapSize(uint64_t format, int width, int height, int depth, int level)
+{
+    return Texture::Calculate(format, std::max(width >> level, 1), std::max(height >> level, 1), std::max(depth >> level, 1));
+}
+//------------------------------------------------------------------------------
+static size_t MipmapSize(StreamState const& state, int level)
+{
+    size_t size = 0;
+    for (int m = level; m < state.mipmap; ++m)
+        size += MipmapSize(state.format, state.width, state.height, state.depth, m);
+    return size;
+}
+//------------------------------------------------------------------------------
+static bool ASTCBlock(uint64_t format, int& blockWidth, int& blockHeight)
+{
+    // "ASTC44" is 4x4, "ASTC105" is 10x5, "ASTC1212" is 12x12
+    if (uint32_t(format) != "ASTC"_cc)
+        return false;
+    char digits[5] = {};
+    memcpy(digits, (char*)&format + 4, 4);
+    size_t length = strlen(digits);
+    if (length < 2)
+        return false;
+    size_t split = length == 2 ? 1 : 2;
+    blockHeight = atoi(digits + split);
+    digits[split] = 0;
+    blockWidth = atoi(digits);
+    return blockWidth > 0 && blockHeight > 0;
+}
+//------------------------------------------------------------------------------
+static bool Skip(xxFile* file, size_t size)
+{
+    char buffer[4096];
+    while (size)
+    {
+        size_t count = std::min(size, sizeof(buffer));
+        if (file->Read(buffer, count) != count)
+            return false;
+        size -= count;
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+static void StreamWorker()
+{
+    for (;;)
+    {
+        StreamJob job;
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            streamCondition.wait(lock, [] { return streamJobs.empty() == false || streamRunning == false; });
+            if (streamRunning == false)
+                return;
+            job = std::move(streamJobs.front());
+            streamJobs.pop_front();
+        }
+
+        xxFile* file = xxFile::Load(job.filename.c_str());
+        xxLocalBreak()
+        {
+            if (file == nullptr)
+                break;
+            size_t skip = job.offset;
+            for (int m = 0; m < job.level; ++m)
+                skip += MipmapSize(job.format, job.width, job.height, job.depth, m);
+            if (Skip(file, skip) == false)
+                break;
+            size_t size = 0;
+            for (int m = job.level; m < job.mipmap; ++m)
+                size += MipmapSize(job.format, job.width, job.height, job.depth, m);
+            job.data.resize(size);
+            if (file->Read(job.data.data(), size) != size)
+                job.data.clear();
+        }
+        delete file;
+
+        std::lock_guard<std::mutex> lock(streamMutex);
+        streamResults.push_back(std::move(job));
+    }
+}
 //------------------------------------------------------------------------------
+static void StreamApply(xxTexturePtr const& texture, StreamState& state, int level, char const* data)
+{
+    texture->Initialize(state.format, std::max(state.width >> level, 1), std::max(state.height >> level, 1), std::max(state.depth >> level, 1), state.mipmap - level, 1);
+    for (int m = level; m < state.mipmap; ++m)
+    {
+        size_t size = MipmapSize(state.format, state.width, state.height, state.depth, m);
+        memcpy((*texture)(0, 0, 0, m - level), data, size);
+        data += size;
+    }
+    texture->Invalidate();
+    state.resident = level;
+}
+//------------------------------------------------------------------------------
+static void StreamEvict(xxTexturePtr const& texture, StreamState& state, int level)
+{
+    std::vector<char> data;
+    for (int m = level; m < state.mipmap; ++m)
+    {
+        size_t size = MipmapSize(state.format, state.width, state.height, state.depth, m);
+        char const* mipmap = (char*)(*texture)(0, 0, 0, m - state.resident);
+        data.insert(data.end(), mipmap, mipmap + size);
+    }
+    StreamApply(texture, state, level, data.data());
+}
+//==============================================================================
 void Texture::Initialize()
 {
     xxTexture::Calculate = Texture::Calculate;
@@ -44,8 +212,94 @@ void Texture::Initialize()
     xxTexture::Reader = Texture::Reader;
 }
 //------------------------------------------------------------------------------
+void Texture::Update()
+{
+    if (streamThread.joinable() == false)
+        return;
+
+    // Finished loads
+    std::deque<StreamJob> results;
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        results.swap(streamResults);
+    }
+    for (StreamJob& job : results)
+    {
+        auto it = streams.find(job.key);
+        if (it == streams.end() || it->second.generation != job.generation)
+            continue;
+        StreamState& state = it->second;
+        state.loading = state.mipmap;
+        if (job.format != state.format || job.width != state.width || job.height != state.height || job.depth != state.depth || job.mipmap != state.mipmap)
+            continue;
+        xxTexturePtr texture = state.texture.lock();
+        if (texture == nullptr || job.data.empty() || job.level >= state.resident)
+            continue;
+        StreamApply(texture, state, job.level, job.data.data());
+        streamStatistics.loadCount++;
+    }
+
+    // Requests from the last frame
+    std::vector<std::pair<unsigned int, xxTexture*>> candidates;
+    size_t residentBytes = 0;
+    size_t pendingCount = 0;
+    for (auto it = streams.begin(); it != streams.end();)
+    {
+        StreamState& state = it->second;
+        xxTexturePtr texture = state.texture.lock();
+        if (texture == nullptr || (*texture)() == nullptr || texture->Mipmap != state.mipmap - state.resident)
+        {
+            it = streams.erase(it);
+            continue;
+        }
+        if (state.requested < state.resident && state.loading == state.mipmap)
+        {
+            state.loading = state.requested;
+            {
+                std::lock_guard<std::mutex> lock(streamMutex);
+                streamJobs.push_back({ it->first, state.generation, state.filename, state.offset, state.format, state.width, state.height, state.depth, state.mipmap, state.requested });
+            }
+            streamCondition.notify_one();
+        }
+        if (state.loading != state.mipmap)
+            pendingCount++;
+        if (state.resident < state.tail && state.frame + 1 < streamFrame)
+            candidates.emplace_back(state.frame, it->first);
+        state.requested = state.tail;
+        residentBytes += MipmapSize(state, state.resident);
+        ++it;
+    }
+
+    // Evict the least recently used mipmaps
+    if (residentBytes > streamBudget)
+    {
+        std::sort(candidates.begin(), candidates.end());
+        for (auto const& [frame, key] : candidates)
+        {
+            if (residentBytes <= streamBudget)
+                break;
+            StreamState& state = streams[key];
+            int level = state.resident;
+            while (level < state.tail && residentBytes > streamBudget)
+            {
+                residentBytes -= MipmapSize(state.format, state.width, state.height, state.depth, level);
+                level++;
+            }
+            StreamEvict(state.texture.lock(), state, level);
+            streamStatistics.evictCount++;
+        }
+    }
+
+    streamStatistics.textureCount = streams.size();
+    streamStatistics.residentBytes = residentBytes;
+    streamStatistics.budgetBytes = streamBudget;
+    streamStatistics.pendingCount = pendingCount;
+    streamFrame++;
+}
+//------------------------------------------------------------------------------
 void Texture::Shutdown()
 {
+    SetStreaming(false);
     textures.clear();
 }
 //------------------------------------------------------------------------------
@@ -73,6 +327,22 @@ size_t Texture::Calculate(uint64_t format, int width, int height, int depth)
         width = (width + 3) / 4;
         height = (height + 3) / 4;
         return width * height * depth * 16;
+    case "R16F"_CC:
+        return width * height * depth * 2;
+    case "RGB10A2"_CC:
+        return width * height * depth * 4;
+    case "RGBA16F"_CC:
+        return width * height * depth * 8;
+    case "RGBA32F"_CC:
+        return width * height * depth * 16;
+    }
+    int blockWidth = 0;
+    int blockHeight = 0;
+    if (ASTCBlock(format, blockWidth, blockHeight))
+    {
+        width = (width + blockWidth - 1) / blockWidth;
+        height = (height + blockHeight - 1) / blockHeight;
+        return width * height * depth * 16;
     }
     size_t channels = 0;
     size_t bits = 0;
@@ -95,16 +365,7 @@ void Texture::Loader(xxTexturePtr& texture, std::string const& path)
     if (texture == nullptr || (*texture)() != nullptr)
         return;
 
-    std::string name;
-    name.reserve(texture->Name.size());
-    for (char c : texture->Name)
-    {
-        if (c >= 'A' && c <= 'Z')
-            c = c + ('a' - 'A');
-        name.push_back(c);
-    }
-
-    auto& ref = textures[name];
+    auto& ref = textures[LowerName(texture->Name)];
     if (ref != nullptr)
     {
         texture = ref;
@@ -125,6 +386,10 @@ void Texture::Reader(xxTexturePtr const& texture)
     {
         DDSReader(texture, filename);
     }
+    else if (strcasestr(texture->Name.c_str(), ".ktx2"))
+    {
+        KTX2Reader(texture, filename);
+    }
     else if (strcasestr(texture->Name.c_str(), ".jpeg") ||
              strcasestr(texture->Name.c_str(), ".jpg") ||
              strcasestr(texture->Name.c_str(), ".png"))
@@ -248,6 +513,10 @@ void Texture::DDSReader(xxTexturePtr const& texture, std::string const& filename
                 case DXGI_FORMAT_B8G8R8A8_UNORM:    format = "BGRA8888"_CC; break;
                 default:
                 case DXGI_FORMAT_R8G8B8A8_UNORM:    format = "RGBA8888"_CC; break;
+                case DXGI_FORMAT_R10G10B10A2_UNORM: format = "RGB10A2"_CC;  break;
+                case DXGI_FORMAT_R16_FLOAT:         format = "R16F"_CC;     break;
+                case DXGI_FORMAT_R16G16B16A16_FLOAT: format = "RGBA16F"_CC;  break;
+                case DXGI_FORMAT_R32G32B32A32_FLOAT: format = "RGBA32F"_CC;  break;
                 case DXGI_FORMAT_BC1_UNORM:         format = "BC1"_cc;      break;
                 case DXGI_FORMAT_BC2_UNORM:         format = "BC2"_cc;      break;
                 case DXGI_FORMAT_BC3_UNORM:         format = "BC3"_cc;      break;
@@ -269,6 +538,31 @@ void Texture::DDSReader(xxTexturePtr const& texture, std::string const& filename
                 mipmap = 1;
             }
         }
+
+        // Only the tail is read when the texture is streamed
+        int level = 0;
+        if (streamThread.joinable() && mipmap > 1 && depth == 1)
+        {
+            auto it = textures.find(LowerName(texture->Name));
+            while (level < mipmap - 1 && std::max(width >> level, height >> level) > STREAM_TAIL)
+                level++;
+            if (it == textures.end() || it->second != texture)
+                level = 0;
+        }
+        if (level)
+        {
+            size_t offset = file->Position();
+            size_t skip = 0;
+            for (int m = 0; m < level; ++m)
+                skip += MipmapSize(format, width, height, depth, m);
+            if (Skip(file, skip) == false)
+                break;
+            streams[texture.get()] = { texture, ++streamGeneration, filename, offset, format, width, height, depth, mipmap, level, level, level, mipmap, streamFrame };
+            width = std::max(width >> level, 1);
+            height = std::max(height >> level, 1);
+            mipmap -= level;
+        }
+
         texture->Initialize(format, width, height, depth, mipmap, 1);
         for (int m = 0; m < mipmap; ++m)
         {
@@ -402,6 +696,297 @@ void Texture::DDSWriter(xxTexturePtr const& texture, std::string const& filename
     delete file;
 }
 //------------------------------------------------------------------------------
+struct KTX2_HEADER
+{
+    uint8_t         identifier[12];
+    uint32_t        vkFormat;
+    uint32_t        typeSize;
+    uint32_t        pixelWidth;
+    uint32_t        pixelHeight;
+    uint32_t        pixelDepth;
+    uint32_t        layerCount;
+    uint32_t        faceCount;
+    uint32_t        levelCount;
+    uint32_t        supercompressionScheme;
+    uint32_t        dfdByteOffset;
+    uint32_t        dfdByteLength;
+    uint32_t        kvdByteOffset;
+    uint32_t        kvdByteLength;
+    uint64_t        sgdByteOffset;
+    uint64_t        sgdByteLength;
+};
+static_assert(sizeof(KTX2_HEADER) == 80);
+//------------------------------------------------------------------------------
+struct KTX2_LEVEL
+{
+    uint64_t        byteOffset;
+    uint64_t        byteLength;
+    uint64_t        uncompressedByteLength;
+};
+static_assert(sizeof(KTX2_LEVEL) == 24);
+//------------------------------------------------------------------------------
+static uint8_t const KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+//------------------------------------------------------------------------------
+static struct { uint32_t vkFormat; uint64_t format; } const KTX2_FORMATS[] =
+{
+    // The first entry of each format is used by the writer, SRGB is read as UNORM
+    {  37, "RGBA8888"_CC }, {  43, "RGBA8888"_CC },
+    {  44, "BGRA8888"_CC }, {  50, "BGRA8888"_CC },
+    {  64, "RGB10A2"_CC },
+    {  76, "R16F"_CC },
+    {  97, "RGBA16F"_CC },
+    { 109, "RGBA32F"_CC },
+    { 133, "BC1"_cc }, { 134, "BC1"_cc }, { 131, "BC1"_cc }, { 132, "BC1"_cc },
+    { 135, "BC2"_cc }, { 136, "BC2"_cc },
+    { 137, "BC3"_cc }, { 138, "BC3"_cc },
+    { 139, "BC4U"_cc },
+    { 140, "BC4S"_cc },
+    { 141, "BC5U"_cc },
+    { 142, "BC5S"_cc },
+    { 144, "BC6H"_cc },
+    { 145, "BC7"_cc }, { 146, "BC7"_cc },
+    { 157, "ASTC44"_CC },   { 158, "ASTC44"_CC },
+    { 159, "ASTC54"_CC },   { 160, "ASTC54"_CC },
+    { 161, "ASTC55"_CC },   { 162, "ASTC55"_CC },
+    { 163, "ASTC65"_CC },   { 164, "ASTC65"_CC },
+    { 165, "ASTC66"_CC },   { 166, "ASTC66"_CC },
+    { 167, "ASTC85"_CC },   { 168, "ASTC85"_CC },
+    { 169, "ASTC86"_CC },   { 170, "ASTC86"_CC },
+    { 171, "ASTC88"_CC },   { 172, "ASTC88"_CC },
+    { 173, "ASTC105"_CC },  { 174, "ASTC105"_CC },
+    { 175, "ASTC106"_CC },  { 176, "ASTC106"_CC },
+    { 177, "ASTC108"_CC },  { 178, "ASTC108"_CC },
+    { 179, "ASTC1010"_CC }, { 180, "ASTC1010"_CC },
+    { 181, "ASTC1210"_CC }, { 182, "ASTC1210"_CC },
+    { 183, "ASTC1212"_CC }, { 184, "ASTC1212"_CC },
+};
+//------------------------------------------------------------------------------
+static std::vector<uint32_t> KTX2Descriptor(uint64_t format)
+{
+    // Basic data format descriptor : color model, block size and one word quad per sample
+    struct Sample { uint32_t offset; uint32_t length; uint32_t channel; uint32_t lower; uint32_t upper; };
+    uint32_t model = 1;
+    uint32_t bytes = 0;
+    int blockWidth = 1;
+    int blockHeight = 1;
+    std::vector<Sample> samples;
+    switch (format)
+    {
+    case "RGBA8888"_CC: bytes = 4;  samples = { { 0, 8, 0, 0, 255 }, { 8, 8, 1, 0, 255 }, { 16, 8, 2, 0, 255 }, { 24, 8, 15, 0, 255 } };         break;
+    case "BGRA8888"_CC: bytes = 4;  samples = { { 0, 8, 2, 0, 255 }, { 8, 8, 1, 0, 255 }, { 16, 8, 0, 0, 255 }, { 24, 8, 15, 0, 255 } };         break;
+    case "RGB10A2"_CC:  bytes = 4;  samples = { { 0, 10, 0, 0, 1023 }, { 10, 10, 1, 0, 1023 }, { 20, 10, 2, 0, 1023 }, { 30, 2, 15, 0, 3 } };  break;
+    case "R16F"_CC:     bytes = 2;  samples = { { 0, 16, 0xC0, 0xBF800000, 0x3F800000 } };                                                   break;
+    case "RGBA16F"_CC:  bytes = 8;  samples = { { 0, 16, 0xC0, 0xBF800000, 0x3F800000 }, { 16, 16, 0xC1, 0xBF800000, 0x3F800000 },
+                                                { 32, 16, 0xC2, 0xBF800000, 0x3F800000 }, { 48, 16, 0xCF, 0xBF800000, 0x3F800000 } };          break;
+    case "RGBA32F"_CC:  bytes = 16; samples = { { 0, 32, 0xC0, 0xBF800000, 0x3F800000 }, { 32, 32, 0xC1, 0xBF800000, 0x3F800000 },
+                                                { 64, 32, 0xC2, 0xBF800000, 0x3F800000 }, { 96, 32, 0xCF, 0xBF800000, 0x3F800000 } };          break;
+    case "BC1"_cc:  model = 128; bytes = 8;  samples = { { 0, 64, 1, 0, 0xFFFFFFFF } };                                                          break;
+    case "BC2"_cc:  model = 129; bytes = 16; samples = { { 0, 64, 15, 0, 0xFFFFFFFF }, { 64, 64, 0, 0, 0xFFFFFFFF } };                          break;
+    case "BC3"_cc:  model = 130; bytes = 16; samples = { { 0, 64, 15, 0, 0xFFFFFFFF }, { 64, 64, 0, 0, 0xFFFFFFFF } };                          break;
+    case "BC4U"_cc: model = 131; bytes = 8;  samples = { { 0, 64, 0, 0, 0xFFFFFFFF } };                                                          break;
+    case "BC4S"_cc: model = 131; bytes = 8;  samples = { { 0, 64, 0x40, 0x80000000, 0x7FFFFFFF } };                                              break;
+    case "BC5U"_cc: model = 132; bytes = 16; samples = { { 0, 64, 0, 0, 0xFFFFFFFF }, { 64, 64, 1, 0, 0xFFFFFFFF } };                           break;
+    case "BC5S"_cc: model = 132; bytes = 16; samples = { { 0, 64, 0x40, 0x80000000, 0x7FFFFFFF }, { 64, 64, 0x41, 0x80000000, 0x7FFFFFFF } };   break;
+    case "BC6H"_cc: model = 133; bytes = 16; samples = { { 0, 128, 0xC0, 0xBF800000, 0x7F800000 } };                                            break;
+    case "BC7"_cc:  model = 134; bytes = 16; samples = { { 0, 128, 0, 0, 0xFFFFFFFF } };                                                         break;
+    default:
+        if (ASTCBlock(format, blockWidth, blockHeight) == false)
+            return {};
+        model = 162;
+        bytes = 16;
+        samples = { { 0, 128, 0, 0, 0xFFFFFFFF } };
+        break;
+    }
+    if (model >= 128 && model < 162)
+    {
+        blockWidth = 4;
+        blockHeight = 4;
+    }
+
+    uint32_t blockSize = uint32_t(24 + 16 * samples.size());
+    std::vector<uint32_t> output;
+    output.push_back(4 + blockSize);
+    output.push_back(0);
+    output.push_back(2 | blockSize << 16);
+    output.push_back(model | 1 << 8 | 1 << 16);
+    output.push_back(uint32_t(blockWidth - 1) | uint32_t(blockHeight - 1) << 8);
+    output.push_back(bytes);
+    output.push_back(0);
+    for (Sample const& sample : samples)
+    {
+        output.push_back(sample.offset | (sample.length - 1) << 16 | sample.channel << 24);
+        output.push_back(0);
+        output.push_back(sample.lower);
+        output.push_back(sample.upper);
+    }
+    return output;
+}
+//------------------------------------------------------------------------------
+void Texture::KTX2Reader(xxTexturePtr const& texture, std::string const& filename)
+{
+    if (texture == nullptr || (*texture)() != nullptr)
+        return;
+
+    xxFile* file = xxFile::Load(filename.c_str());
+    xxLocalBreak()
+    {
+        if (file == nullptr)
+            break;
+        KTX2_HEADER header;
+        if (file->Read(&header, sizeof(KTX2_HEADER)) != sizeof(KTX2_HEADER))
+            break;
+        if (memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+            break;
+        if (header.supercompressionScheme != 0)
+        {
+            xxLog(TAG, "Supercompression is not supported (%d) %s", header.supercompressionScheme, xxFile::GetName(filename.c_str(), true).c_str());
+            break;
+        }
+        uint64_t format = 0;
+        for (auto const& pair : KTX2_FORMATS)
+        {
+            if (pair.vkFormat == header.vkFormat)
+            {
+                format = pair.format;
+                break;
+            }
+        }
+        if (format == 0)
+        {
+            xxLog(TAG, "Format is not supported (%d) %s", header.vkFormat, xxFile::GetName(filename.c_str(), true).c_str());
+            break;
+        }
+        int width = std::max<int>(header.pixelWidth, 1);
+        int height = std::max<int>(header.pixelHeight, 1);
+        int depth = std::max<int>(header.pixelDepth, 1);
+        int mipmap = std::max<int>(header.levelCount, 1);
+        int array = std::max<int>(header.layerCount, 1) * std::max<int>(header.faceCount, 1);
+
+        std::vector<KTX2_LEVEL> levels(mipmap);
+        if (file->Read(levels.data(), sizeof(KTX2_LEVEL) * mipmap) != sizeof(KTX2_LEVEL) * mipmap)
+            break;
+
+        // Levels are usually stored from the smallest, read them in file order
+        std::vector<int> order(mipmap);
+        for (int m = 0; m < mipmap; ++m)
+            order[m] = m;
+        std::sort(order.begin(), order.end(), [&](int left, int right) { return levels[left].byteOffset < levels[right].byteOffset; });
+
+        texture->Initialize(format, width, height, depth, mipmap, array);
+        size_t position = file->Position();
+        bool failed = false;
+        for (int m : order)
+        {
+            size_t size = MipmapSize(format, width, height, depth, m);
+            if (levels[m].byteLength != size * array || levels[m].byteOffset < position)
+            {
+                xxLog(TAG, "Level %d is corrupted %s", m, xxFile::GetName(filename.c_str(), true).c_str());
+                failed = true;
+                break;
+            }
+            if (Skip(file, levels[m].byteOffset - position) == false)
+            {
+                failed = true;
+                break;
+            }
+            for (int a = 0; a < array && failed == false; ++a)
+            {
+                if (file->Read((*texture)(0, 0, 0, m, a), size) != size)
+                    failed = true;
+            }
+            if (failed)
+                break;
+            position = levels[m].byteOffset + levels[m].byteLength;
+        }
+        if (failed)
+        {
+            texture->Initialize(0, 0, 0, 0, 0, 0);
+        }
+    }
+    delete file;
+}
+//------------------------------------------------------------------------------
+void Texture::KTX2Writer(xxTexturePtr const& texture, std::string const& filename)
+{
+    if (texture == nullptr || (*texture)() == nullptr)
+        return;
+
+    uint32_t vkFormat = 0;
+    for (auto const& pair : KTX2_FORMATS)
+    {
+        if (pair.format == texture->Format)
+        {
+            vkFormat = pair.vkFormat;
+            break;
+        }
+    }
+    std::vector<uint32_t> descriptor = KTX2Descriptor(texture->Format);
+    if (vkFormat == 0 || descriptor.empty())
+        return;
+
+    int width = texture->Width;
+    int height = texture->Height;
+    int depth = texture->Depth;
+    int mipmap = texture->Mipmap;
+    int array = texture->Array;
+
+    KTX2_HEADER header = {};
+    memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    header.vkFormat = vkFormat;
+    header.typeSize = 1;
+    switch (texture->Format)
+    {
+    case "R16F"_CC:
+    case "RGBA16F"_CC:  header.typeSize = 2;    break;
+    case "RGB10A2"_CC:
+    case "RGBA32F"_CC:  header.typeSize = 4;    break;
+    }
+    header.pixelWidth = width;
+    header.pixelHeight = height;
+    header.pixelDepth = depth > 1 ? depth : 0;
+    header.layerCount = array > 1 ? array : 0;
+    header.faceCount = 1;
+    header.levelCount = mipmap;
+    header.dfdByteOffset = uint32_t(sizeof(KTX2_HEADER) + sizeof(KTX2_LEVEL) * mipmap);
+    header.dfdByteLength = uint32_t(sizeof(uint32_t) * descriptor.size());
+
+    // Smallest level first, every level is aligned to the block size and 4
+    size_t alignment = std::max<size_t>(MipmapSize(texture->Format, 1, 1, 1, 0), 4);
+    std::vector<KTX2_LEVEL> levels(mipmap);
+    size_t offset = header.dfdByteOffset + header.dfdByteLength;
+    for (int m = mipmap - 1; m >= 0; --m)
+    {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        levels[m].byteOffset = offset;
+        levels[m].byteLength = MipmapSize(texture->Format, width, height, depth, m) * array;
+        levels[m].uncompressedByteLength = levels[m].byteLength;
+        offset += levels[m].byteLength;
+    }
+
+    xxFile* file = xxFile::Save(filename.c_str());
+    xxLocalBreak()
+    {
+        if (file == nullptr)
+            break;
+        file->Write(&header, sizeof(KTX2_HEADER));
+        file->Write(levels.data(), sizeof(KTX2_LEVEL) * mipmap);
+        file->Write(descriptor.data(), sizeof(uint32_t) * descriptor.size());
+        size_t position = header.dfdByteOffset + header.dfdByteLength;
+        for (int m = mipmap - 1; m >= 0; --m)
+        {
+            static char const padding[16] = {};
+            file->Write(padding, levels[m].byteOffset - position);
+            size_t size = MipmapSize(texture->Format, width, height, depth, m);
+            for (int a = 0; a < array; ++a)
+            {
+                file->Write((*texture)(0, 0, 0, m, a), size);
+            }
+            position = levels[m].byteOffset + levels[m].byteLength;
+        }
+    }
+    delete file;
+}
+//------------------------------------------------------------------------------
 void Texture::STBReader(xxTexturePtr const& texture, std::string const& filename)
 {
     if (texture == nullptr || (*texture)() != nullptr)
@@ -430,4 +1015,66 @@ void Texture::STBReader(xxTexturePtr const& texture, std::string const& filename
 
     stbi_image_free(uc);
 }
+//------------------------------------------------------------------------------
+void Texture::SetStreaming(bool enable, size_t budget)
+{
+    streamBudget = budget;
+    if (enable == streamThread.joinable())
+        return;
+
+    if (enable)
+    {
+        streamRunning = true;
+        streamThread = std::thread(StreamWorker);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        streamRunning = false;
+    }
+    streamCondition.notify_all();
+    streamThread.join();
+    streamJobs.clear();
+    streamResults.clear();
+    streams.clear();
+    streamStatistics = {};
+}
+//------------------------------------------------------------------------------
+bool Texture::IsStreaming()
+{
+    return streamThread.joinable();
+}
+//------------------------------------------------------------------------------
+void Texture::Stream(xxTexturePtr const& texture, float pixel)
+{
+    if (texture == nullptr)
+        return;
+    auto it = streams.find(texture.get());
+    if (it == streams.end() || it->second.texture.lock() != texture)
+        return;
+    StreamState& state = it->second;
+
+    // One texel per pixel across the largest side
+    int level = 0;
+    if (pixel >= 1.0f)
+        level = int(log2f(std::max(state.width, state.height) / pixel));
+    level = std::clamp(level, 0, state.tail);
+    state.requested = std::min(state.requested, level);
+    state.frame = streamFrame;
+    streamStatistics.requestCount++;
+}
+//------------------------------------------------------------------------------
+int Texture::GetResidentMipmap(xxTexturePtr const& texture)
+{
+    auto it = streams.find(texture.get());
+    if (it == streams.end() || it->second.texture.lock() != texture)
+        return 0;
+    return it->second.resident;
+}
+//------------------------------------------------------------------------------
+Texture::StreamingStatistics Texture::GetStreamingStatistics()
+{
+    return streamStatistics;
+}
 //==============================================================================
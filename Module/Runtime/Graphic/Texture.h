@@ -10,12 +10,32 @@
 
 struct RuntimeAPI Texture
 {
+    struct StreamingStatistics
+    {
+        size_t textureCount;
+        size_t residentBytes;
+        size_t budgetBytes;
+        size_t pendingCount;
+        size_t requestCount;
+        size_t loadCount;
+        size_t evictCount;
+    };
+
     static void Initialize();
+    static void Update();
     static void Shutdown();
     static size_t Calculate(uint64_t format, int width, int height, int depth);
     static void Loader(xxTexturePtr& texture, std::string const& path);
     static void Reader(xxTexturePtr const& texture);
     static void DDSReader(xxTexturePtr const& texture, std::string const& filename);
     static void DDSWriter(xxTexturePtr const& texture, std::string const& filename);
+    static void KTX2Reader(xxTexturePtr const& texture, std::string const& filename);
+    static void KTX2Writer(xxTexturePtr const& texture, std::string const& filename);
     static void STBReader(xxTexturePtr const& texture, std::string const& filename);
+
+    static void SetStreaming(bool enable, size_t budget = 256 * 1024 * 1024);
+    static bool IsStreaming();
+    static void Stream(xxTexturePtr const& texture, float pixel);
+    static int  GetResidentMipmap(xxTexturePtr const& texture);
+    static StreamingStatistics GetStreamingStatistics();
 };
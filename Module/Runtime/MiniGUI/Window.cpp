@@ -164,28 +164,16 @@ void Window::SetScale(xxVector2 const& scale)
     LocalMatrix[1].y = scale.y;
     Flags |= UPDATE_TEXT;
 
-    // Update flag
+    // The subtree is recomputed from here
     Flags |= UPDATE_NEED;
-    WindowPtr parent = GetParent();
-    while (parent)
-    {
-        parent->Flags |= UPDATE_NEED;
-        parent = parent->GetParent();
-    }
 }
 //------------------------------------------------------------------------------
 void Window::SetOffset(xxVector2 const& offset)
 {
     LocalMatrix[3].xy = offset;
 
-    // Update flag
+    // The subtree is recomputed from here
     Flags |= UPDATE_NEED;
-    WindowPtr parent = GetParent();
-    while (parent)
-    {
-        parent->Flags |= UPDATE_NEED;
-        parent = parent->GetParent();
-    }
 }
 //==============================================================================
 //  Node
@@ -269,8 +257,9 @@ void Window::Update(WindowPtr const& window, float time, xxVector2 const& screen
         resize = true;
     }
 
-    auto callback = [&](WindowPtr const& window)
+    auto callback = [&](Node* node)
     {
+        Window* window = static_cast<Window*>(node);
         if (resize)
         {
             window->Flags |= UPDATE_TEXT_SCALE;
@@ -279,14 +268,11 @@ void Window::Update(WindowPtr const& window, float time, xxVector2 const& screen
         {
             window->UpdateText();
         }
-        if (window->Flags & UPDATE_NEED)
-        {
-            window->Flags &= ~UPDATE_NEED;
-            window->UpdateMatrix();
-        }
         return true;
     };
-    Traversal(window, callback);
+    Visit(window, callback);
+
+    NodeTools::UpdateWorldMatrix(window, 0, UPDATE_NEED);
 }
 //==============================================================================
 //  Binary
@@ -23,7 +23,7 @@ void BakedQuaternion16Modifier::Update(void* target, float time, xxModifierData*
     auto node = (Node*)target;
     xxVector4 L = { __builtin_convertvector(*A, v4sf) };
     xxVector4 R = { __builtin_convertvector(*B, v4sf) };
-    node->SetRotate(xxMatrix3::Quaternion(Lerp(L, R, F) / INT16_MAX));
+    node->SetRotate(xxMatrix3::Quaternion(Slerp(L / INT16_MAX, R / INT16_MAX, F)));
 }
 //------------------------------------------------------------------------------
 xxModifierPtr BakedQuaternion16Modifier::Create(size_t count, float duration, std::function<void(size_t index, xxVector4& quaternion)> fill)
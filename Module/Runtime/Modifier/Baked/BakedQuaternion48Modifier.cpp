@@ -0,0 +1,101 @@
+//==============================================================================
+// Minamoto : BakedQuaternion48Modifier Source
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#include "Runtime.h"
+#include "Graphic/Node.h"
+#include "BakedQuaternion48Modifier.h"
+#include "Modifier/Modifier.inl"
+
+//==============================================================================
+//  BakedQuaternion48Modifier
+//==============================================================================
+void BakedQuaternion48Modifier::Update(void* target, float time, xxModifierData* data)
+{
+    Value* A;
+    Value* B;
+    float F;
+    if (UpdateBakedFactor(data, time, (Baked*)Data.data(), A, B, F) == false)
+        return;
+
+    auto node = (Node*)target;
+    node->SetRotate(xxMatrix3::Quaternion(Slerp(Decode(*A), Decode(*B), F)));
+}
+//------------------------------------------------------------------------------
+void BakedQuaternion48Modifier::Encode(Value& value, xxVector4 const& quaternion)
+{
+    static int const remains[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+
+    // Drop the largest component, and flip the sign so it is positive
+    int index = 0;
+    for (int i = 1; i < 4; ++i)
+    {
+        if (std::fabs(quaternion.v[i]) > std::fabs(quaternion.v[index]))
+            index = i;
+    }
+    float scale = float(M_SQRT2 * INT16_MAX);
+    v4sf scaled = quaternion.v * (quaternion.v[index] < 0.0f ? -scale : scale);
+
+    // Remaining components are within [-1/sqrt(2), 1/sqrt(2)]
+    int components[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        float component = std::clamp(scaled[remains[index][i]], -float(INT16_MAX), float(INT16_MAX));
+        if (i < 2)
+            components[i] = std::clamp(int(std::lrintf(component * 0.5f)), -INT16_MAX / 2, INT16_MAX / 2) * 2;
+        else
+            components[i] = int(std::lrintf(component));
+    }
+    value[0] = int16_t(components[0] | (index & 1));
+    value[1] = int16_t(components[1] | (index >> 1));
+    value[2] = int16_t(components[2]);
+}
+//------------------------------------------------------------------------------
+xxVector4 BakedQuaternion48Modifier::Decode(Value const& value)
+{
+    v4hi packed = { value[0], value[1], value[2], 0 };
+    int index = (packed[0] & 1) | (packed[1] & 1) << 1;
+    packed &= v4hi{ -2, -2, -1, 0 };
+
+    // Restore the dropped component from the unit length
+    v4sf v = __builtin_convertvector(packed, v4sf) * float(M_SQRT1_2 / INT16_MAX);
+    v4sf square = v * v;
+    float w = std::sqrt(std::max(0.0f, 1.0f - square[0] - square[1] - square[2]));
+
+    // Lanes before the index keep their place, lanes after it shift up by one
+    v4si lane = { 0, 1, 2, 3 };
+    v4si before = lane < index;
+    v4si at = lane == index;
+    v4si low = (v4si)v;
+    v4si high = (v4si)v4sf{ 0.0f, v[0], v[1], v[2] };
+    v4si dropped = (v4si)v4sf{ w, w, w, w };
+    return { (v4sf)((low & before) | (dropped & at) | (high & ~(before | at))) };
+}
+//------------------------------------------------------------------------------
+xxModifierPtr BakedQuaternion48Modifier::Create(size_t count, float duration, std::function<void(size_t index, xxVector4& quaternion)> fill)
+{
+    if (count <= 1)
+        return nullptr;
+
+    xxModifierPtr modifier = xxModifier::Create(sizeof(Baked) + sizeof(Value) * count);
+    if (modifier == nullptr)
+        return nullptr;
+
+    Loader(*modifier, BAKED_QUATERNION48);
+    if (fill)
+    {
+        auto* baked = (Baked*)modifier->Data.data();
+        baked->duration = duration;
+        baked->frequency = (count - 1) / duration;
+        for (size_t i = 0; i < count; ++i)
+        {
+            xxVector4 quaternion;
+            fill(i, quaternion);
+            Encode(baked->values[i], quaternion);
+        }
+    }
+    return modifier;
+}
+//==============================================================================
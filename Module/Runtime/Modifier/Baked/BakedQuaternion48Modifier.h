@@ -0,0 +1,32 @@
+//==============================================================================
+// Minamoto : BakedQuaternion48Modifier Header
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#pragma once
+
+#include "Modifier/Modifier.h"
+
+class RuntimeAPI BakedQuaternion48Modifier : public Modifier
+{
+public:
+    // Smallest three components, the index of the dropped one is kept in the low bits of the first two
+    typedef int16_t Value[3];
+    struct Baked
+    {
+        float duration;
+        float frequency;
+        Value values[];
+    };
+    static_assert(sizeof(Baked) == 8);
+    static_assert(sizeof(Value) == 6);
+
+public:
+    void                    Update(void* target, float time, xxModifierData* data) override;
+
+    static void             Encode(Value& value, xxVector4 const& quaternion);
+    static xxVector4        Decode(Value const& value);
+
+    static xxModifierPtr    Create(size_t count = 0, float duration = 0.0f, std::function<void(size_t index, xxVector4& quaternion)> fill = nullptr);
+};
@@ -21,7 +21,7 @@ void BakedQuaternionModifier::Update(void* target, float time, xxModifierData* d
         return;
 
     auto node = (Node*)target;
-    node->SetRotate(xxMatrix3::Quaternion(Lerp(*A, *B, F)));
+    node->SetRotate(xxMatrix3::Quaternion(Slerp(*A, *B, F)));
 }
 //------------------------------------------------------------------------------
 xxModifierPtr BakedQuaternionModifier::Create(size_t count, float duration, std::function<void(size_t index, xxVector4& quaternion)> fill)
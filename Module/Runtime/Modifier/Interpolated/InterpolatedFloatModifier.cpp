@@ -26,6 +26,11 @@ void InterpolatedFloatModifier::Update(void* target, float time, xxModifierData*
     if (UpdateInterpolatedFactor(data, time, A, B, F) == false)
         return;
 
+    Apply(target, A, B, F);
+}
+//------------------------------------------------------------------------------
+void InterpolatedFloatModifier::Apply(void* target, Key const* A, Key const* B, float F)
+{
     *(float*)target = Lerp(A->value, B->value, F);
 }
 //------------------------------------------------------------------------------
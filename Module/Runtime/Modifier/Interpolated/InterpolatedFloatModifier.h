@@ -21,6 +21,7 @@ public:
 public:
     void                    Assign(void* source, float time) override;
     void                    Update(void* target, float time, xxModifierData* data) override;
+    void                    Apply(void* target, Key const* A, Key const* B, float F);
 
     static xxModifierPtr    Create(size_t count = 0, std::function<void(size_t index, float& time, float& value)> fill = nullptr);
 };
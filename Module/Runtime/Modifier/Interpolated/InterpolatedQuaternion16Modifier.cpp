@@ -20,10 +20,15 @@ void InterpolatedQuaternion16Modifier::Update(void* target, float time, xxModifi
     if (UpdateInterpolatedFactor(data, time, A, B, F) == false)
         return;
 
+    Apply(target, A, B, F);
+}
+//------------------------------------------------------------------------------
+void InterpolatedQuaternion16Modifier::Apply(void* target, Key const* A, Key const* B, float F)
+{
     auto node = (Node*)target;
     xxVector4 L = { __builtin_convertvector((v4hi&)A->quaternion, v4sf) };
     xxVector4 R = { __builtin_convertvector((v4hi&)B->quaternion, v4sf) };
-    node->SetRotate(xxMatrix3::Quaternion(Lerp(L, R, F) / INT16_MAX));
+    node->SetRotate(xxMatrix3::Quaternion(Slerp(L / INT16_MAX, R / INT16_MAX, F)));
 }
 //------------------------------------------------------------------------------
 xxModifierPtr InterpolatedQuaternion16Modifier::Create(size_t count, std::function<void(size_t index, float& time, xxVector4& quaternion)> fill)
@@ -24,6 +24,7 @@ public:
 
 public:
     void                    Update(void* target, float time, xxModifierData* data) override;
+    void                    Apply(void* target, Key const* A, Key const* B, float F);
 
     static xxModifierPtr    Create(size_t count = 0, std::function<void(size_t index, float& time, xxVector4& quaternion)> fill = nullptr);
 };
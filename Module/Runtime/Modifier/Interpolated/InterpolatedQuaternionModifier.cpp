@@ -20,8 +20,13 @@ void InterpolatedQuaternionModifier::Update(void* target, float time, xxModifier
     if (UpdateInterpolatedFactor(data, time, A, B, F) == false)
         return;
 
+    Apply(target, A, B, F);
+}
+//------------------------------------------------------------------------------
+void InterpolatedQuaternionModifier::Apply(void* target, Key const* A, Key const* B, float F)
+{
     auto node = (Node*)target;
-    node->SetRotate(xxMatrix3::Quaternion(Lerp((xxVector4&)A->quaternion, (xxVector4&)B->quaternion, F)));
+    node->SetRotate(xxMatrix3::Quaternion(Slerp((xxVector4&)A->quaternion, (xxVector4&)B->quaternion, F)));
 }
 //------------------------------------------------------------------------------
 xxModifierPtr InterpolatedQuaternionModifier::Create(size_t count, std::function<void(size_t index, float& time, xxVector4& quaternion)> fill)
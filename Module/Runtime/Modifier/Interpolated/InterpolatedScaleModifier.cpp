@@ -20,6 +20,11 @@ void InterpolatedScaleModifier::Update(void* target, float time, xxModifierData*
     if (UpdateInterpolatedFactor(data, time, A, B, F) == false)
         return;
 
+    Apply(target, A, B, F);
+}
+//------------------------------------------------------------------------------
+void InterpolatedScaleModifier::Apply(void* target, Key const* A, Key const* B, float F)
+{
     auto node = (Node*)target;
     node->SetScale(Lerp(A->scale, B->scale, F));
     node->UpdateRotateTranslateScale();
@@ -20,6 +20,11 @@ void InterpolatedTranslateModifier::Update(void* target, float time, xxModifierD
     if (UpdateInterpolatedFactor(data, time, A, B, F) == false)
         return;
 
+    Apply(target, A, B, F);
+}
+//------------------------------------------------------------------------------
+void InterpolatedTranslateModifier::Apply(void* target, Key const* A, Key const* B, float F)
+{
     auto node = (Node*)target;
     node->SetTranslate(Lerp(A->translate, B->translate, F));
 }
@@ -20,11 +20,13 @@
 #include "InterpolatedQuaternion16Modifier.h"
 #include "BakedQuaternionModifier.h"
 #include "BakedQuaternion16Modifier.h"
+#include "BakedQuaternion48Modifier.h"
 #if HAVE_PARTICLE
 #include "Particle/SprayParticleModifier.h"
 #include "Particle/SuperSprayParticleModifier.h"
 #endif
 #include "Modifier.h"
+#include "Modifier.inl"
 
 extern "C" {
 extern void* _ZTV13FloatModifier;
@@ -41,6 +43,7 @@ extern void* _ZTV25InterpolatedScaleModifier;
 extern void* _ZTV32InterpolatedQuaternion16Modifier;
 extern void* _ZTV23BakedQuaternionModifier;
 extern void* _ZTV25BakedQuaternion16Modifier;
+extern void* _ZTV25BakedQuaternion48Modifier;
 #if HAVE_PARTICLE
 extern void* _ZTV21SprayParticleModifier;
 extern void* _ZTV26SuperSprayParticleModifier;
@@ -62,6 +65,7 @@ extern void* _ZTV26SuperSprayParticleModifier;
 #pragma comment(linker, "/alternatename:__ZTV32InterpolatedQuaternion16Modifier=??_7InterpolatedQuaternion16Modifier@@6B@")
 #pragma comment(linker, "/alternatename:__ZTV23BakedQuaternionModifier=??_7BakedQuaternionModifier@@6B@")
 #pragma comment(linker, "/alternatename:__ZTV25BakedQuaternion16Modifier=??_7BakedQuaternion16Modifier@@6B@")
+#pragma comment(linker, "/alternatename:__ZTV25BakedQuaternion48Modifier=??_7BakedQuaternion48Modifier@@6B@")
 #if HAVE_PARTICLE
 #pragma comment(linker, "/alternatename:__ZTV21SprayParticleModifier=??_7SprayParticleModifier@@6B@")
 #pragma comment(linker, "/alternatename:__ZTV26SuperSprayParticleModifier=??_7SuperSprayParticleModifier@@6B@")
@@ -81,6 +85,7 @@ extern void* _ZTV26SuperSprayParticleModifier;
 #pragma comment(linker, "/alternatename:_ZTV32InterpolatedQuaternion16Modifier=??_7InterpolatedQuaternion16Modifier@@6B@")
 #pragma comment(linker, "/alternatename:_ZTV23BakedQuaternionModifier=??_7BakedQuaternionModifier@@6B@")
 #pragma comment(linker, "/alternatename:_ZTV25BakedQuaternion16Modifier=??_7BakedQuaternion16Modifier@@6B@")
+#pragma comment(linker, "/alternatename:_ZTV25BakedQuaternion48Modifier=??_7BakedQuaternion48Modifier@@6B@")
 #if HAVE_PARTICLE
 #pragma comment(linker, "/alternatename:_ZTV21SprayParticleModifier=??_7SprayParticleModifier@@6B@")
 #pragma comment(linker, "/alternatename:_ZTV26SuperSprayParticleModifier=??_7SuperSprayParticleModifier@@6B@")
@@ -111,7 +116,8 @@ static struct { std::string name; void** vtable; size_t header; size_t size; } c
     { "INTERPOLATED_QUATERNION16",  &_ZTV32InterpolatedQuaternion16Modifier,    0,  sizeof(InterpolatedQuaternion16Modifier::Key) },
     {}, {}, {}, {}, {}, {}, {}, {}, {}, {},
     { "BAKED_QUATERNION",           &_ZTV23BakedQuaternionModifier,     sizeof(BakedQuaternionModifier::Baked),         sizeof(xxVector4) },
-                                                {}, {}, {}, {},
+                                                {}, {}, {},
+    { "BAKED_QUATERNION48",         &_ZTV25BakedQuaternion48Modifier,   sizeof(BakedQuaternion48Modifier::Baked),       sizeof(BakedQuaternion48Modifier::Value) },
     { "BAKED_QUATERNION16",         &_ZTV25BakedQuaternion16Modifier,   sizeof(BakedQuaternion16Modifier::Baked),       sizeof(v4hi) },
 #if HAVE_PARTICLE
     { "SPRAY_PARTICLE",             &_ZTV21SprayParticleModifier,       sizeof(SprayParticleModifier::Parameter),       1 },
@@ -175,3 +181,102 @@ size_t Modifier::CalculateSize(size_t type, size_t count)
     return loaders[type].header + loaders[type].size * count;
 }
 //==============================================================================
+//------------------------------------------------------------------------------
+size_t Modifier::UpdateInterpolatedFactor(xxModifierData* const* data, size_t count, float time, void const** A, void const** B, float* F)
+{
+    // Channels with the same key times at the same local time take the segment
+    // found for the previous channel instead of searching again
+    float sharedTime = 0.0f;
+    size_t shared = SIZE_MAX;
+    size_t updated = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        A[i] = nullptr;
+
+        xxModifierData* current = data[i];
+        xxModifier* modifier = current->modifier.get();
+        size_t type = modifier->DataType;
+        if (type < INTERPOLATED_FLOAT || type > INTERPOLATED_QUATERNION16 || loaders[type].vtable == nullptr)
+            continue;
+        if (current->time == time)
+            continue;
+        current->time = time;
+
+        if (current->start == 0.0f)
+            current->start = time;
+        float local = time - current->start;
+
+        char const* key = (char const*)modifier->Data.data();
+        size_t stride = loaders[type].size;
+        size_t keyCount = modifier->Data.size() / stride;
+        auto at = [key, stride](size_t index) { return *(float const*)(key + stride * index); };
+
+        if (keyCount == 0)
+            continue;
+        if (keyCount == 1)
+        {
+            A[i] = key;
+            B[i] = key;
+            F[i] = 1.0f;
+            updated++;
+            continue;
+        }
+        size_t index = 0;
+        if (keyCount > 2)
+        {
+            float duration = at(keyCount - 1);
+            if (local < 0.0f || local >= duration)
+                local = std::fmodf(local, duration);
+
+            index = FindInterpolated(key, stride, keyCount, current->index, local, local == sharedTime ? shared : SIZE_MAX);
+            if (index == SIZE_MAX)
+                continue;
+            sharedTime = local;
+            shared = index;
+        }
+        A[i] = key + stride * (index + 0);
+        B[i] = key + stride * (index + 1);
+        float XY = at(index + 1) - at(index);
+        F[i] = (local - at(index)) / XY;
+        updated++;
+    }
+    return updated;
+}
+//------------------------------------------------------------------------------
+template<class T>
+static void Apply(xxModifier* modifier, void* target, void const* A, void const* B, float F)
+{
+    if (A == nullptr)
+        return;
+    ((T*)modifier)->Apply(target, (typename T::Key const*)A, (typename T::Key const*)B, F);
+}
+//------------------------------------------------------------------------------
+void Modifier::UpdateBatch(void* const* targets, xxModifierData* const* data, size_t count, float time)
+{
+    void const* A[64];
+    void const* B[64];
+    float F[64];
+    for (size_t begin = 0; begin < count; begin += xxCountOf(F))
+    {
+        size_t size = std::min(count - begin, xxCountOf(F));
+        UpdateInterpolatedFactor(data + begin, size, time, A, B, F);
+
+        // Applied in the original order, the scale channel composes the node matrix
+        for (size_t i = 0; i < size; ++i)
+        {
+            void* target = targets[begin + i];
+            xxModifierData* current = data[begin + i];
+            xxModifier* modifier = current->modifier.get();
+            switch (modifier->DataType)
+            {
+            case INTERPOLATED_FLOAT:        Apply<InterpolatedFloatModifier>(modifier, target, A[i], B[i], F[i]);         break;
+            case INTERPOLATED_QUATERNION:   Apply<InterpolatedQuaternionModifier>(modifier, target, A[i], B[i], F[i]);    break;
+            case INTERPOLATED_TRANSLATE:    Apply<InterpolatedTranslateModifier>(modifier, target, A[i], B[i], F[i]);     break;
+            case INTERPOLATED_SCALE:        Apply<InterpolatedScaleModifier>(modifier, target, A[i], B[i], F[i]);         break;
+            case INTERPOLATED_QUATERNION16: Apply<InterpolatedQuaternion16Modifier>(modifier, target, A[i], B[i], F[i]);  break;
+            default:                        modifier->Update(target, time, current);                                      break;
+            }
+        }
+    }
+}
+//==============================================================================
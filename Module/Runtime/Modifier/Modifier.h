@@ -35,6 +35,7 @@ public:
         BAKED_QUATERNION            = 0x2A, // Node
         BAKED_TRANSLATE             = 0x2B, // Node
         BAKED_SCALE                 = 0x2C, // Node
+        BAKED_QUATERNION48          = 0x2E, // Node
         BAKED_QUATERNION16          = 0x2F, // Node
 #if HAVE_PARTICLE
         SPRAY_PARTICLE              = 0x30, // Node
@@ -49,8 +50,13 @@ public:
 public:
     template<class T> void          AssignInterpolated(T& K);
     template<class T> bool          UpdateInterpolatedFactor(xxModifierData* data, float time, T*& A, T*& B, float& F);
+    static size_t                   UpdateInterpolatedFactor(xxModifierData* const* data, size_t count, float time, void const** A, void const** B, float* F);
+    static size_t                   FindInterpolated(void const* key, size_t stride, size_t count, size_t& cursor, float time, size_t shared);
     template<class T, class D> bool UpdateBakedFactor(xxModifierData* data, float time, D* baked, T*& A, T*& B, float& F);
     template<class T> T             Lerp(T const& A, T const &B, float F);
+    template<class T> static T      Slerp(T const& A, T const &B, float F);   // Corrected nlerp, approximate
+
+    static void                     UpdateBatch(void* const* targets, xxModifierData* const* data, size_t count, float time);
 
     static void                     Initialize();
     static void                     Shutdown();
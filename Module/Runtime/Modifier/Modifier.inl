@@ -29,6 +29,56 @@ void Modifier::AssignInterpolated(T& K)
     keys.insert(keys.end(), K);
 }
 
+inline size_t Modifier::FindInterpolated(void const* key, size_t stride, size_t count, size_t& cursor, float time, size_t shared)
+{
+    // Every interpolated key starts with its time
+    auto at = [key, stride](size_t index) { return *(float const*)((char const*)key + stride * index); };
+    size_t maximum = count - 2;
+    size_t index = std::min(cursor, maximum);
+
+    // Rewind after a loop or a backward seek
+    size_t first = index;
+    if (at(index) > time)
+    {
+        if (at(0) > time)
+        {
+            cursor = 0;
+            return SIZE_MAX;
+        }
+        first = index = 0;
+    }
+
+    // Cursor, next key, the segment of another channel with the same key times,
+    // then binary search for the first key not before time
+    if (at(index + 1) < time)
+    {
+        if (index < maximum && at(index + 2) >= time)
+        {
+            index = index + 1;
+        }
+        else if (shared <= maximum && at(shared) < time && at(shared + 1) >= time)
+        {
+            index = shared;
+        }
+        else
+        {
+            size_t lower = first + 1;
+            size_t upper = maximum + 1;
+            while (lower < upper)
+            {
+                size_t middle = (lower + upper) / 2;
+                if (at(middle) < time)
+                    lower = middle + 1;
+                else
+                    upper = middle;
+            }
+            index = lower - 1;
+        }
+    }
+    cursor = index;
+    return index;
+}
+
 template<class T>
 bool Modifier::UpdateInterpolatedFactor(xxModifierData* data, float time, T*& A, T*& B, float& F)
 {
@@ -60,30 +110,15 @@ bool Modifier::UpdateInterpolatedFactor(xxModifierData* data, float time, T*& A,
     else
     {
         float duration = key[count - 1].time;
-        size_t maximum = count - 2;
-        size_t index = std::min(data->index, maximum);
+        if (time < 0.0f || time >= duration)
+            time = std::fmodf(time, duration);
+
+        size_t index = FindInterpolated(key, sizeof(T), count, data->index, time, SIZE_MAX);
+        if (index == SIZE_MAX)
+            return false;
         A = &key[index + 0];
         B = &key[index + 1];
-
-        time = std::fmodf(time, duration);
-        if (A->time > time)
-        {
-            data->index = index = 0;
-            A = &key[0];
-            B = &key[1];
-            if (A->time > time)
-            {
-                return false;
-            }
-        }
-        while (B->time < time && index < maximum)
-        {
-            data->index = ++index;
-            ++A;
-            ++B;
-        }
     }
-
     float XY = B->time - A->time;
     F = (time - A->time) / XY;
     return true;
@@ -115,3 +150,21 @@ T Modifier::Lerp(T const& A, T const &B, float F)
 {
     return A + (B - A) * F;
 }
+
+template<class T>
+T Modifier::Slerp(T const& A, T const &B, float F)
+{
+    // Not an exact slerp : a normalized lerp along the shorter arc whose factor is
+    // corrected by a fitted polynomial, the angular velocity is close to constant
+    // but not exact, so the result differs slightly from a true slerp between keys
+    v4sf AB = A.v * B.v;
+    float dot = AB[0] + AB[1] + AB[2] + AB[3];
+    float d = std::fabs(dot);
+    float a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+    float b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+    float k = a * (F - 0.5f) * (F - 0.5f) + b;
+    float t = F + F * (F - 0.5f) * (F - 1.0f) * k;
+    T C = A * (1.0f - t) + B * (dot < 0.0f ? -t : t);
+    v4sf CC = C.v * C.v;
+    return C / std::sqrt(CC[0] + CC[1] + CC[2] + CC[3]);
+}
@@ -54,6 +54,55 @@ xxVector3 ParticleModifier::RandomFloat3(int& seed)
     return output / float(INT_MAX);
 }
 //------------------------------------------------------------------------------
+ParticleModifier::RandomBatch::RandomBatch(int seed) : seed(seed)
+{
+}
+//------------------------------------------------------------------------------
+int ParticleModifier::RandomBatch::Next()
+{
+    if (index == 4)
+    {
+        // seed(n + k) = A^k * seed(n) + C * (A^(k-1) + ... + 1)
+        static constexpr uint32_t A1 = 214013;
+        static constexpr uint32_t C1 = 2531011;
+        static constexpr uint32_t A2 = A1 * A1;
+        static constexpr uint32_t C2 = C1 * A1 + C1;
+        static constexpr uint32_t A3 = A2 * A1;
+        static constexpr uint32_t C3 = C2 * A1 + C1;
+        static constexpr uint32_t A4 = A3 * A1;
+        static constexpr uint32_t C4 = C3 * A1 + C1;
+        v4si base = { seed, seed, seed, seed };
+        v4si multiply = { int(A1), int(A2), int(A3), int(A4) };
+        v4si increment = { int(C1), int(C2), int(C3), int(C4) };
+        v4si value = base * multiply + increment;
+        memcpy(values, &value, sizeof(values));
+        index = 0;
+    }
+    return seed = values[index++];
+}
+//------------------------------------------------------------------------------
+float ParticleModifier::RandomBatch::NextFloat()
+{
+    return Next() / float(INT_MAX);
+}
+//------------------------------------------------------------------------------
+xxVector2 ParticleModifier::RandomBatch::NextFloat2()
+{
+    xxVector2 output;
+    output.x = Next();
+    output.y = Next();
+    return output / float(INT_MAX);
+}
+//------------------------------------------------------------------------------
+xxVector3 ParticleModifier::RandomBatch::NextFloat3()
+{
+    xxVector3 output;
+    output.x = Next();
+    output.y = Next();
+    output.z = Next();
+    return output / float(INT_MAX);
+}
+//------------------------------------------------------------------------------
 void ParticleModifier::SetParticleCount(Mesh* mesh, int count)
 {
     mesh->SetIndexCount(count * 6);
@@ -97,6 +146,49 @@ int ParticleModifier::SetParticleData(Mesh* mesh, Particle* particles, int count
 
     int now = 0;
 
+    // Position, color and texture are packed into 24 bytes, a quad is six vectors
+    if (mesh->Skinning == false && mesh->NormalCount == 0 && mesh->ColorCount == 1 && mesh->TextureCount == 1)
+    {
+        char* vertex = mesh->Storage[Mesh::VERTEX];
+        for (int i = 0; i < count; ++i)
+        {
+            Particle& particle = particles[i];
+            if (particle.age <= 0.0f)
+                continue;
+            v4sf point;
+            v4sf radian;
+            v4sf color;
+            memcpy(&point, &particle.point, sizeof(v4sf));
+            memcpy(&radian, &particle.radian, sizeof(v4sf));
+            memcpy(&color[0], vertex + 12, sizeof(float));
+            memcpy(&color[1], vertex + 36, sizeof(float));
+            memcpy(&color[2], vertex + 60, sizeof(float));
+            memcpy(&color[3], vertex + 84, sizeof(float));
+            v4sf p0 = __builtin_shufflevector(point, color, 0, 1, 2, 4);
+            v4sf p1 = __builtin_shufflevector(point, color, 0, 1, 2, 5);
+            v4sf p2 = __builtin_shufflevector(point, color, 0, 1, 2, 6);
+            v4sf p3 = __builtin_shufflevector(point, color, 0, 1, 2, 7);
+            v4sf t = __builtin_shufflevector(radian, -radian, 0, 1, 4, 5);
+            v4sf quad[6] =
+            {
+                p0,
+                __builtin_shufflevector(t, p1, 2, 3, 4, 5),
+                __builtin_shufflevector(p1, t, 2, 3, 6, 5),
+                p2,
+                __builtin_shufflevector(t, p3, 0, 1, 4, 5),
+                __builtin_shufflevector(p3, t, 2, 3, 4, 7),
+            };
+            memcpy(vertex, quad, sizeof(quad));
+            vertex += sizeof(quad);
+            now++;
+        }
+
+        mesh->ActiveCount[Mesh::INDEX] = now * 6;
+        mesh->ActiveCount[Mesh::VERTEX] = now * 4;
+
+        return now;
+    }
+
     auto positions = mesh->GetPosition();
     auto textures = mesh->GetTexture();
     for (int i = 0; i < count; ++i)
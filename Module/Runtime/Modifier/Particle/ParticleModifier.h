@@ -26,6 +26,20 @@ public:
         float grow;
     };
 
+    // Four steps of Random at once, consumed in the same order
+    struct RuntimeAPI RandomBatch
+    {
+        RandomBatch(int seed);
+        int Next();
+        float NextFloat();
+        xxVector2 NextFloat2();
+        xxVector3 NextFloat3();
+
+        int seed;
+        int index = 4;
+        int values[4];
+    };
+
 public:
     void UpdateValues(float* values, size_t count, float time, xxModifierData* data);
 
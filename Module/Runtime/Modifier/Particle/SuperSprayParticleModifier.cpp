@@ -12,6 +12,82 @@
 
 #if HAVE_PARTICLE
 
+//==============================================================================
+static void Transpose(v4sf& a, v4sf& b, v4sf& c, v4sf& d)
+{
+    v4sf t0 = __builtin_shufflevector(a, b, 0, 4, 1, 5);
+    v4sf t1 = __builtin_shufflevector(a, b, 2, 6, 3, 7);
+    v4sf t2 = __builtin_shufflevector(c, d, 0, 4, 1, 5);
+    v4sf t3 = __builtin_shufflevector(c, d, 2, 6, 3, 7);
+    a = __builtin_shufflevector(t0, t2, 0, 1, 4, 5);
+    b = __builtin_shufflevector(t0, t2, 2, 3, 6, 7);
+    c = __builtin_shufflevector(t1, t3, 0, 1, 4, 5);
+    d = __builtin_shufflevector(t1, t3, 2, 3, 6, 7);
+}
+//------------------------------------------------------------------------------
+static v4sf Select(v4si mask, v4sf a, v4sf b)
+{
+    return (v4sf)(((v4si)a & mask) | ((v4si)b & ~mask));
+}
+//------------------------------------------------------------------------------
+static int Integrate(ParticleModifier::Particle* quad, float delta, float life, float fade, float grow)
+{
+    // Four particles are twelve vectors, each group of four rows is transposed
+    // [point.x point.y point.z radian] [size age velocity.x velocity.y] [velocity.z spin fade grow]
+    v4sf rows[12];
+    memcpy(rows, quad, sizeof(rows));
+    Transpose(rows[0], rows[3], rows[6], rows[9]);
+    Transpose(rows[1], rows[4], rows[7], rows[10]);
+    Transpose(rows[2], rows[5], rows[8], rows[11]);
+    v4sf& x = rows[0];
+    v4sf& y = rows[3];
+    v4sf& z = rows[6];
+    v4sf& radian = rows[9];
+    v4sf& size = rows[1];
+    v4sf& age = rows[4];
+    v4sf& vx = rows[7];
+    v4sf& vy = rows[10];
+    v4sf& vz = rows[2];
+    v4sf& spin = rows[5];
+    v4sf& fadeSpeed = rows[8];
+    v4sf& growSpeed = rows[11];
+
+    v4sf zero = {};
+    v4si alive = ~(age <= zero);
+    int mask = (alive[0] & 1) | (alive[1] & 2) | (alive[2] & 4) | (alive[3] & 8);
+    if (mask == 0)
+        return 0;
+
+    // Same operations in the same order as the scalar loop
+    v4sf d = { delta, delta, delta, delta };
+    v4sf newAge = age - d;
+    v4sf mx = vx * d;
+    v4sf my = vy * d;
+    v4sf mz = vz * d;
+    v4sf newX = x + mx;
+    v4sf newY = y + my;
+    v4sf newZ = z + mz;
+    v4sf newRadian = radian + spin * d;
+    v4sf fadeAge = { fade, fade, fade, fade };
+    v4sf growAge = { grow, grow, grow, grow };
+    v4sf lifeAge = { life, life, life, life };
+    v4si fading = fadeAge > newAge;
+    v4si growing = ~fading & (growAge > lifeAge - newAge);
+    v4sf newSize = Select(fading, size - fadeSpeed * d, Select(growing, size + growSpeed * d, size));
+
+    age = Select(alive, newAge, age);
+    x = Select(alive, newX, x);
+    y = Select(alive, newY, y);
+    z = Select(alive, newZ, z);
+    radian = Select(alive, newRadian, radian);
+    size = Select(alive, newSize, size);
+
+    Transpose(rows[0], rows[3], rows[6], rows[9]);
+    Transpose(rows[1], rows[4], rows[7], rows[10]);
+    Transpose(rows[2], rows[5], rows[8], rows[11]);
+    memcpy(quad, rows, sizeof(rows));
+    return mask;
+}
 //==============================================================================
 //  SuperSprayParticleModifier
 //==============================================================================
@@ -56,58 +132,82 @@ void SuperSprayParticleModifier::Update(void* target, float time, xxModifierData
         particleBirth = std::min<int>(truncf(during * birthRate) - truncf((during - delta) * birthRate), during * rate);
     }
 
+    RandomBatch random(header->seed);
+    auto spawn = [&](Particle& particle)
+    {
+        particle.point.xy = (random.NextFloat2() * 0.5f) * parameter->range;
+        particle.point.z = 0.0f;
+        particle.radian = float(M_PI * 2.0f) + parameter->phase;
+        if (parameter->phaseVariation != 0.0f)
+        {
+            particle.radian += random.NextFloat() * parameter->phaseVariation;
+        }
+        particle.size = parameter->size;
+        if (parameter->sizeVariation != 0.0f)
+        {
+            particle.size += random.NextFloat() * parameter->sizeVariation;
+        }
+        particle.age = parameter->life;
+        if (parameter->lifeVariation != 0.0f)
+        {
+            particle.age += random.NextFloat() * parameter->lifeVariation;
+        }
+        xxVector2 theta = parameter->offset + random.NextFloat2() * parameter->spread;
+        particle.velocity.x = sinf(theta.x) * sinf(theta.y);
+        particle.velocity.y = sinf(theta.x) * cosf(theta.y);
+        particle.velocity.z = cosf(theta.x);
+        particle.velocity = particle.velocity * parameter->speed;
+        if (parameter->speedVariation != 0.0f)
+        {
+            particle.velocity += random.NextFloat3() * parameter->speedVariation;
+        }
+        particle.spin = 0.0f;
+        if (parameter->spin != 0.0f)
+        {
+            particle.spin = float(M_PI * 2.0f) / parameter->spin;
+            if (parameter->spinVariation != 0.0f)
+            {
+                particle.spin += random.NextFloat() * parameter->spinVariation;
+            }
+        }
+        if (parameter->fade != 0.0f)
+        {
+            particle.fade = particle.size / parameter->fade;
+        }
+        if (parameter->grow != 0.0f)
+        {
+            particle.grow = particle.size / parameter->grow;
+            particle.size = 0.0f;
+        }
+    };
+
+    // Alive lanes are integrated together, dead lanes are born in index order
     Particle* particles = header->particles;
-    for (Particle& particle : std::span(particles, particleCount))
+    int index = 0;
+    for (; index + 4 <= particleCount; index += 4)
+    {
+        Particle* quad = particles + index;
+        int alive = Integrate(quad, delta, parameter->life, parameter->fade, parameter->grow);
+        if (alive == 0b1111)
+            continue;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (alive & (1 << i))
+                continue;
+            if (particleBorn >= particleBirth)
+                continue;
+            particleBorn++;
+            spawn(quad[i]);
+        }
+    }
+    for (Particle& particle : std::span(particles + index, particleCount - index))
     {
         if (particle.age <= 0.0f)
         {
             if (particleBorn >= particleBirth)
                 continue;
             particleBorn++;
-            particle.point.xy = (RandomFloat2(header->seed) * 0.5f) * parameter->range;
-            particle.point.z = 0.0f;
-            particle.radian = float(M_PI * 2.0f) + parameter->phase;
-            if (parameter->phaseVariation != 0.0f)
-            {
-                particle.radian += RandomFloat(header->seed) * parameter->phaseVariation;
-            }
-            particle.size = parameter->size;
-            if (parameter->sizeVariation != 0.0f)
-            {
-                particle.size += RandomFloat(header->seed) * parameter->sizeVariation;
-            }
-            particle.age = parameter->life;
-            if (parameter->lifeVariation != 0.0f)
-            {
-                particle.age += RandomFloat(header->seed) * parameter->lifeVariation;
-            }
-            xxVector2 theta = parameter->offset + RandomFloat2(header->seed) * parameter->spread;
-            particle.velocity.x = sinf(theta.x) * sinf(theta.y);
-            particle.velocity.y = sinf(theta.x) * cosf(theta.y);
-            particle.velocity.z = cosf(theta.x);
-            particle.velocity = particle.velocity * parameter->speed;
-            if (parameter->speedVariation != 0.0f)
-            {
-                particle.velocity += RandomFloat3(header->seed) * parameter->speedVariation;
-            }
-            particle.spin = 0.0f;
-            if (parameter->spin != 0.0f)
-            {
-                particle.spin = float(M_PI * 2.0f) / parameter->spin;
-                if (parameter->spinVariation != 0.0f)
-                {
-                    particle.spin += RandomFloat(header->seed) * parameter->spinVariation;
-                }
-            }
-            if (parameter->fade != 0.0f)
-            {
-                particle.fade = particle.size / parameter->fade;
-            }
-            if (parameter->grow != 0.0f)
-            {
-                particle.grow = particle.size / parameter->grow;
-                particle.size = 0.0f;
-            }
+            spawn(particle);
             continue;
         }
         particle.age -= delta;
@@ -122,6 +222,7 @@ void SuperSprayParticleModifier::Update(void* target, float time, xxModifierData
             particle.size += particle.grow * delta;
         }
     }
+    header->seed = random.seed;
 
     const_cast<xxVector4&>(mesh->Bound) = parameter->bound;
     parameter->now = SetParticleData(mesh, particles, particleCount, parameter->size);
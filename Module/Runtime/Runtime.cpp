@@ -24,6 +24,7 @@
 #endif
 #include "Script/Lua.h"
 #include "Script/QuickJS.h"
+#include "Tools/JobSystem.h"
 #include "Runtime.h"
 
 //==============================================================================
@@ -49,6 +50,7 @@ void Runtime::Initialize()
         return;
     initialized = true;
 
+    JobSystem::Initialize();
     Lua::Initialize();
     QuickJS::Initialize();
 
@@ -67,6 +69,7 @@ void Runtime::Initialize()
 void Runtime::Update()
 {
     Buffer::Update();
+    Texture::Update();
     Material::FrameCount++;
 }
 //------------------------------------------------------------------------------
@@ -96,6 +99,7 @@ void Runtime::Shutdown(bool suspend)
     {
         QuickJS::Shutdown();
         Lua::Shutdown();
+        JobSystem::Shutdown();
     }
 
 #if HAVE_MINIGUI
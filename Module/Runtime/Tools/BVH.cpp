@@ -0,0 +1,284 @@
+//==============================================================================
+// Minamoto : BVH Source
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#include "Runtime.h"
+#include <algorithm>
+#include "Graphic/Node.h"
+#if HAVE_MINIGUI
+#include "MiniGUI/Window.h"
+#endif
+#include "BVH.h"
+
+static int const LEAF_SIZE = 4;
+static int const STACK_SIZE = 64;
+
+//==============================================================================
+static float Axis(xxVector4 const& vector, int axis)
+{
+    return axis == 0 ? vector.x : axis == 1 ? vector.y : vector.z;
+}
+//==============================================================================
+void BVH::Build(xxNodePtr const& root)
+{
+    Clear();
+    if (root == nullptr)
+        return;
+
+    // Same leaves as DrawTools::CullTraversal
+    auto collect = [this](auto&& collect, xxNodePtr const& node) -> void
+    {
+        if (node->Mesh)
+        {
+            m_references.push_back(node);
+            return;
+        }
+        for (xxNodePtr const& child : (*node))
+            collect(collect, child);
+    };
+    for (xxNodePtr const& child : (*root))
+    {
+#if HAVE_MINIGUI
+        if (MiniGUI::Window::Cast(child))
+            continue;
+#endif
+        collect(collect, child);
+    }
+    if (m_references.empty())
+        return;
+
+    int count = int(m_references.size());
+    m_itemNodes.resize(count);
+    m_itemBounds.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        m_itemNodes[i] = m_references[i].get();
+        m_itemBounds[i] = m_references[i]->WorldBound;
+    }
+
+    // Subdivide sorts the item order kept in m_itemLeaves, then items are laid out in leaf order
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+    m_itemLeaves.swap(order);
+    m_branches.reserve(count / LEAF_SIZE * 2 + 1);
+    m_parents.reserve(count / LEAF_SIZE * 2 + 1);
+    m_branches.push_back({});
+    m_parents.push_back(-1);
+    Subdivide(0, 0, count);
+    m_itemLeaves.swap(order);
+    m_itemLeaves.resize(count);
+
+    std::vector<Node*> nodes(count);
+    std::vector<xxVector4> bounds(count);
+    for (int i = 0; i < count; ++i)
+    {
+        nodes[i] = m_itemNodes[order[i]];
+        bounds[i] = m_itemBounds[order[i]];
+    }
+    m_itemNodes.swap(nodes);
+    m_itemBounds.swap(bounds);
+
+    // Children are always after their parent
+    for (int i = int(m_branches.size()) - 1; i >= 0; --i)
+    {
+        Branch const& branch = m_branches[i];
+        for (int j = branch.first; j < branch.first + branch.count; ++j)
+            m_itemLeaves[j] = i;
+        UpdateBranch(i);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (m_itemNodes[i]->Flags & xxNode::UPDATE_NEED)
+            m_dynamicItems.push_back(i);
+    }
+}
+//------------------------------------------------------------------------------
+void BVH::Refit()
+{
+    m_refitCount = 0;
+    for (int item : m_dynamicItems)
+    {
+        xxVector4 const& bound = m_itemNodes[item]->WorldBound;
+        if (memcmp(&m_itemBounds[item], &bound, sizeof(xxVector4)) == 0)
+            continue;
+        m_itemBounds[item] = bound;
+        m_refitCount++;
+
+        // Walk up until a branch does not change
+        int index = m_itemLeaves[item];
+        while (index >= 0)
+        {
+            Branch before = m_branches[index];
+            UpdateBranch(index);
+            if (memcmp(&before, &m_branches[index], sizeof(Branch)) == 0)
+                break;
+            index = m_parents[index];
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void BVH::Clear()
+{
+    m_branches.clear();
+    m_parents.clear();
+    m_itemLeaves.clear();
+    m_dynamicItems.clear();
+    m_itemNodes.clear();
+    m_itemBounds.clear();
+    m_references.clear();
+    m_refitCount = 0;
+}
+//------------------------------------------------------------------------------
+void BVH::Cull(xxMatrix4x2 const frustum[6], std::vector<Node*>& array) const
+{
+    if (m_branches.empty())
+        return;
+
+    struct Entry { int index; char planes; };
+    Entry stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = { 0, char(frustum ? 0b111111 : 0) };
+    while (top)
+    {
+        Entry entry = stack[--top];
+        Branch const& branch = m_branches[entry.index];
+        char planes = entry.planes;
+
+        if (planes)
+        {
+            xxVector3 center = (branch.minimum + branch.maximum) * 0.5f;
+            xxVector3 extent = (branch.maximum - branch.minimum) * 0.5f;
+            bool outside = false;
+            for (int i = 0; i < 6; ++i)
+            {
+                char bit = (1 << i);
+                if (planes & bit)
+                {
+                    xxVector3 const& normal = frustum[i][0].xyz;
+                    float direction = normal.Dot(center - frustum[i][1].xyz);
+                    float radius = fabsf(normal.x) * extent.x + fabsf(normal.y) * extent.y + fabsf(normal.z) * extent.z;
+                    if (direction < -radius)
+                    {
+                        outside = true;
+                        break;
+                    }
+                    if (direction > radius)
+                        planes &= ~bit;
+                }
+            }
+            if (outside)
+                continue;
+        }
+
+        if (branch.count == 0)
+        {
+            stack[top++] = { branch.first + 0, planes };
+            stack[top++] = { branch.first + 1, planes };
+            continue;
+        }
+
+        for (int i = branch.first; i < branch.first + branch.count; ++i)
+        {
+            if (planes)
+            {
+                // Same test as DrawTools::CullTraversal
+                xxVector4 const& bound = m_itemBounds[i];
+                bool outside = false;
+                for (int j = 0; j < 6; ++j)
+                {
+                    if (planes & (1 << j))
+                    {
+                        float direction = frustum[j][0].xyz.Dot(bound.xyz - frustum[j][1].xyz);
+                        if (direction < -bound.radius)
+                        {
+                            outside = true;
+                            break;
+                        }
+                    }
+                }
+                if (outside)
+                    continue;
+            }
+            array.push_back(m_itemNodes[i]);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+size_t BVH::GetNodeCount() const
+{
+    return m_itemNodes.size();
+}
+//------------------------------------------------------------------------------
+size_t BVH::GetRefitCount() const
+{
+    return m_refitCount;
+}
+//------------------------------------------------------------------------------
+void BVH::Subdivide(int index, int begin, int end)
+{
+    if (end - begin <= LEAF_SIZE)
+    {
+        m_branches[index].first = begin;
+        m_branches[index].count = end - begin;
+        return;
+    }
+
+    // Median split on the longest axis of the centers
+    int* order = m_itemLeaves.data();
+    xxVector4 minimum = m_itemBounds[order[begin]];
+    xxVector4 maximum = m_itemBounds[order[begin]];
+    for (int i = begin + 1; i < end; ++i)
+    {
+        xxVector4 const& bound = m_itemBounds[order[i]];
+        minimum.xyz = { std::min(minimum.x, bound.x), std::min(minimum.y, bound.y), std::min(minimum.z, bound.z) };
+        maximum.xyz = { std::max(maximum.x, bound.x), std::max(maximum.y, bound.y), std::max(maximum.z, bound.z) };
+    }
+    xxVector3 size = maximum.xyz - minimum.xyz;
+    int axis = (size.x >= size.y && size.x >= size.z) ? 0 : (size.y >= size.z) ? 1 : 2;
+
+    int middle = begin + (end - begin) / 2;
+    std::nth_element(order + begin, order + middle, order + end, [&](int left, int right)
+    {
+        return Axis(m_itemBounds[left], axis) < Axis(m_itemBounds[right], axis);
+    });
+
+    int left = int(m_branches.size());
+    m_branches.push_back({});
+    m_branches.push_back({});
+    m_parents.push_back(index);
+    m_parents.push_back(index);
+    m_branches[index].first = left;
+    m_branches[index].count = 0;
+
+    Subdivide(left + 0, begin, middle);
+    Subdivide(left + 1, middle, end);
+}
+//------------------------------------------------------------------------------
+void BVH::UpdateBranch(int index)
+{
+    Branch& branch = m_branches[index];
+    if (branch.count == 0)
+    {
+        Branch const& left = m_branches[branch.first + 0];
+        Branch const& right = m_branches[branch.first + 1];
+        branch.minimum = { std::min(left.minimum.x, right.minimum.x), std::min(left.minimum.y, right.minimum.y), std::min(left.minimum.z, right.minimum.z) };
+        branch.maximum = { std::max(left.maximum.x, right.maximum.x), std::max(left.maximum.y, right.maximum.y), std::max(left.maximum.z, right.maximum.z) };
+        return;
+    }
+
+    xxVector3 minimum = { FLT_MAX, FLT_MAX, FLT_MAX };
+    xxVector3 maximum = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = branch.first; i < branch.first + branch.count; ++i)
+    {
+        xxVector4 const& bound = m_itemBounds[i];
+        minimum = { std::min(minimum.x, bound.x - bound.radius), std::min(minimum.y, bound.y - bound.radius), std::min(minimum.z, bound.z - bound.radius) };
+        maximum = { std::max(maximum.x, bound.x + bound.radius), std::max(maximum.y, bound.y + bound.radius), std::max(maximum.z, bound.z + bound.radius) };
+    }
+    branch.minimum = minimum;
+    branch.maximum = maximum;
+}
+//==============================================================================
@@ -0,0 +1,43 @@
+//==============================================================================
+// Minamoto : BVH Header
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#pragma once
+
+#include "Runtime.h"
+
+// Bounding volume hierarchy over the world bound of drawable nodes
+class RuntimeAPI BVH
+{
+public:
+    void    Build(xxNodePtr const& root);
+    void    Refit();
+    void    Clear();
+    void    Cull(xxMatrix4x2 const frustum[6], std::vector<Node*>& array) const;
+
+    size_t  GetNodeCount() const;
+    size_t  GetRefitCount() const;
+
+protected:
+    struct Branch
+    {
+        xxVector3 minimum;
+        int first;      // Leaf : first item, Branch : left child
+        xxVector3 maximum;
+        int count;      // Leaf : item count, Branch : 0
+    };
+
+    void    Subdivide(int index, int begin, int end);
+    void    UpdateBranch(int index);
+
+    std::vector<Branch> m_branches;
+    std::vector<int> m_parents;
+    std::vector<int> m_itemLeaves;
+    std::vector<int> m_dynamicItems;
+    std::vector<Node*> m_itemNodes;
+    std::vector<xxVector4> m_itemBounds;
+    std::vector<xxNodePtr> m_references;
+    size_t m_refitCount = 0;
+};
@@ -6,88 +6,227 @@
 //==============================================================================
 #include "Runtime.h"
 #include <xxGraphicPlus/xxFile.h>
-#include "CSV.h"
+#include <charconv>
+#include "CSV.inl"
 
 //==============================================================================
 bool CSV::Load(char const* name, std::function<void(std::vector<std::string_view> const&)> deserialize, std::string_view separate)
 {
-    xxFile* file = xxFile::Load(name);
+    std::vector<char> buffer;
+    if (Read(name, buffer) == false)
+        return false;
+
+    Parse(buffer.data(), buffer.size(), deserialize, separate.empty() ? ',' : separate.front());
+    return true;
+}
+//------------------------------------------------------------------------------
+bool CSV::Save(char const* name, std::function<void(std::vector<std::string_view>&)> serialize, std::string_view separate)
+{
+    xxFile* file = xxFile::Save(name);
     if (file == nullptr)
         return false;
 
-    std::string buffer;
     std::vector<std::string_view> rows;
     for (;;)
     {
-        // Read
-        size_t position = buffer.size();
-        buffer.resize(position + 256);
-        size_t length = file->Read(buffer.data() + position, buffer.size() - position);
-        buffer.resize(position + length);
-        if (buffer.empty())
+        rows.clear();
+        serialize(rows);
+        if (rows.empty())
             break;
 
-        for (;;)
+        // Write
+        for (size_t i = 0; i < rows.size(); ++i)
         {
-            size_t breakline = buffer.find_first_of("\r\n");
-            if (breakline == std::string::npos)
-                break;
-
-            // Find comma
-            std::string_view line = std::string_view(buffer.c_str(), breakline);
-            while (line.empty() == false)
+            if (i != 0)
             {
-                size_t comma = std::min(line.size(), line.find_first_of(separate));
-                rows.push_back(line.substr(0, comma));
-                line.remove_prefix(std::min(line.size(), comma + 1));
+                file->Write(separate.data(), separate.size());
+            }
+            std::string_view const& string = rows[i];
+            if (string.find_first_of(separate) == std::string_view::npos && string.find_first_of("\"\r\n") == std::string_view::npos)
+            {
+                file->Write(string.data(), string.size());
+                continue;
             }
-            deserialize(rows);
-            rows.clear();
 
-            // Skip breakline
-            while (buffer.size() > breakline)
+            // Quote
+            file->Write("\"", 1);
+            for (size_t begin = 0; begin <= string.size(); )
             {
-                char c = buffer[breakline];
-                if (c != '\r' && c != '\n')
+                size_t quote = std::min(string.size(), string.find('"', begin));
+                file->Write(string.data() + begin, quote - begin);
+                if (quote == string.size())
                     break;
-                breakline++;
+                file->Write("\"\"", 2);
+                begin = quote + 1;
             }
-            buffer.erase(buffer.begin(), buffer.begin() + breakline);
+            file->Write("\"", 1);
         }
+        file->Write("\n", 1);
     }
 
     delete file;
     return true;
 }
 //------------------------------------------------------------------------------
-bool CSV::Save(char const* name, std::function<void(std::vector<std::string_view>&)> serialize, std::string_view separate)
+bool CSV::Read(char const* name, std::vector<char>& buffer)
 {
-    xxFile* file = xxFile::Save(name);
+    xxFile* file = xxFile::Load(name);
     if (file == nullptr)
         return false;
 
-    std::vector<std::string_view> rows;
-    for (;;)
+    buffer.resize(file->Size());
+    size_t length = file->Read(buffer.data(), buffer.size());
+    buffer.resize(length);
+
+    delete file;
+    return true;
+}
+//==============================================================================
+//  Convert
+//==============================================================================
+static std::string_view Trim(std::string_view field)
+{
+    while (field.empty() == false && (field.front() == ' ' || field.front() == '\t'))
+        field.remove_prefix(1);
+    while (field.empty() == false && (field.back() == ' ' || field.back() == '\t'))
+        field.remove_suffix(1);
+    if (field.size() > 1 && field.front() == '+' && field[1] != '-')
+        field.remove_prefix(1);
+    return field;
+}
+//------------------------------------------------------------------------------
+template<class T>
+static bool ConvertInteger(std::string_view field, T& value)
+{
+    field = Trim(field);
+    char const* end = field.data() + field.size();
+    auto result = std::from_chars(field.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+//------------------------------------------------------------------------------
+bool CSV::Convert(std::string_view field, int& value)
+{
+    return ConvertInteger(field, value);
+}
+//------------------------------------------------------------------------------
+bool CSV::Convert(std::string_view field, int64_t& value)
+{
+    return ConvertInteger(field, value);
+}
+//------------------------------------------------------------------------------
+bool CSV::Convert(std::string_view field, unsigned int& value)
+{
+    return ConvertInteger(field, value);
+}
+//------------------------------------------------------------------------------
+bool CSV::Convert(std::string_view field, float& value)
+{
+    double result = 0.0;
+    if (Convert(field, result) == false)
+        return false;
+    value = float(result);
+    return true;
+}
+//------------------------------------------------------------------------------
+bool CSV::Convert(std::string_view field, double& value)
+{
+    field = Trim(field);
+    if (field.empty())
+        return false;
+
+    // Exact when the mantissa and the power of ten are both representable
+    static double const powers[] =
     {
-        rows.clear();
-        serialize(rows);
-        if (rows.empty())
-            break;
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
 
-        // Write
-        for (size_t i = 0; i < rows.size(); ++i)
+    char const* p = field.data();
+    char const* end = p + field.size();
+    bool negative = (*p == '-');
+    if (negative)
+        p++;
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool exact = true;
+    bool number = false;
+    for (; p < end && unsigned(*p - '0') < 10; ++p)
+    {
+        number = true;
+        if (digits < 19)
         {
-            if (i != 0)
+            mantissa = mantissa * 10 + (*p - '0');
+            digits += mantissa ? 1 : 0;
+        }
+        else
+        {
+            exact &= (*p == '0');
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && unsigned(*p - '0') < 10; ++p)
+        {
+            number = true;
+            if (digits < 19)
             {
-                file->Write(separate.data(), separate.size());
+                mantissa = mantissa * 10 + (*p - '0');
+                digits += mantissa ? 1 : 0;
+                exponent--;
+            }
+            else
+            {
+                exact &= (*p == '0');
             }
-            std::string_view const& string = rows[i];
-            file->Write(string.data(), string.size());
         }
-        file->Write("\n", 1);
+    }
+    if (number && p < end && (*p == 'e' || *p == 'E'))
+    {
+        char const* q = p + 1;
+        bool negativeExponent = (q < end && *q == '-');
+        if (q < end && (*q == '-' || *q == '+'))
+            q++;
+        int power = 0;
+        bool valid = false;
+        for (; q < end && unsigned(*q - '0') < 10; ++q)
+        {
+            power = std::min(power * 10 + (*q - '0'), 100000);
+            valid = true;
+        }
+        if (valid)
+        {
+            exponent += negativeExponent ? -power : power;
+            p = q;
+        }
     }
 
-    delete file;
-    return true;
+    if (number && p == end && exact && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        double result = double(mantissa);
+        result = exponent < 0 ? result / powers[-exponent] : result * powers[exponent];
+        value = negative ? -result : result;
+        return true;
+    }
+
+    // Fallback for long mantissas, large exponents, inf and nan
+    char stack[64];
+    std::string heap;
+    char const* string = stack;
+    if (field.size() < sizeof(stack))
+    {
+        memcpy(stack, field.data(), field.size());
+        stack[field.size()] = 0;
+    }
+    else
+    {
+        heap = field;
+        string = heap.c_str();
+    }
+    char* last = nullptr;
+    value = strtod(string, &last);
+    return last != string && last == string + field.size();
 }
 //==============================================================================
@@ -15,4 +15,16 @@ struct RuntimeAPI CSV
 {
     static bool Load(char const* name, std::function<void(std::vector<std::string_view> const&)> deserialize, std::string_view separate = ",");
     static bool Save(char const* name, std::function<void(std::vector<std::string_view>&)> serialize, std::string_view separate = ",");
+
+    // Fields point into the buffer, quoted fields are unescaped in place
+    static bool Read(char const* name, std::vector<char>& buffer);
+    template<class F> static void Parse(char* text, size_t size, F&& deserialize, char separate = ',');
+
+    static bool Convert(std::string_view field, int& value);
+    static bool Convert(std::string_view field, int64_t& value);
+    static bool Convert(std::string_view field, unsigned int& value);
+    static bool Convert(std::string_view field, float& value);
+    static bool Convert(std::string_view field, double& value);
+    static bool Convert(std::string_view field, std::string_view& value) { value = field; return true; }
+    template<class... Args> static bool Columns(std::vector<std::string_view> const& fields, Args&... values);
 };
@@ -0,0 +1,69 @@
+//==============================================================================
+// Minamoto : CSV Header
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#pragma once
+
+#include "CSV.h"
+
+template<class F>
+void CSV::Parse(char* text, size_t size, F&& deserialize, char separate)
+{
+    std::vector<std::string_view> fields;
+    char* end = text + size;
+    char* p = text;
+    while (p < end)
+    {
+        // Skip breakline
+        if (*p == '\r' || *p == '\n')
+        {
+            p++;
+            continue;
+        }
+
+        fields.clear();
+        for (;;)
+        {
+            char* begin = p;
+            if (p < end && *p == '"')
+            {
+                char* output = begin;
+                for (p++; p < end; )
+                {
+                    char c = *p++;
+                    if (c == '"')
+                    {
+                        if (p == end || *p != '"')
+                            break;
+                        p++;
+                    }
+                    (*output++) = c;
+                }
+                fields.emplace_back(begin, output - begin);
+                while (p < end && *p != separate && *p != '\r' && *p != '\n')
+                    p++;
+            }
+            else
+            {
+                while (p < end && *p != separate && *p != '\r' && *p != '\n')
+                    p++;
+                fields.emplace_back(begin, p - begin);
+            }
+            if (p == end || *p != separate)
+                break;
+            p++;
+        }
+        deserialize(fields);
+    }
+}
+//------------------------------------------------------------------------------
+template<class... Args>
+bool CSV::Columns(std::vector<std::string_view> const& fields, Args&... values)
+{
+    if (fields.size() < sizeof...(Args))
+        return false;
+    size_t index = 0;
+    return (Convert(fields[index++], values) && ...);
+}
@@ -0,0 +1,203 @@
+//==============================================================================
+// Minamoto : Compression Source
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#include "Runtime.h"
+#include "Compression.h"
+
+//==============================================================================
+static size_t constexpr MINMATCH = 4;
+static size_t constexpr LASTLITERALS = 5;
+static size_t constexpr MFLIMIT = 12;
+static size_t constexpr MAXDISTANCE = 65535;
+static int constexpr HASHLOG = 14;
+//------------------------------------------------------------------------------
+static uint32_t Read32(uint8_t const* pointer)
+{
+    uint32_t value;
+    memcpy(&value, pointer, sizeof(uint32_t));
+    return value;
+}
+//------------------------------------------------------------------------------
+static uint32_t Hash32(uint32_t value)
+{
+    return (value * 2654435761u) >> (32 - HASHLOG);
+}
+//------------------------------------------------------------------------------
+static uint8_t* WriteLength(uint8_t* op, uint8_t const* opEnd, size_t length)
+{
+    while (length >= 255)
+    {
+        if (op >= opEnd)
+            return nullptr;
+        (*op++) = 255;
+        length -= 255;
+    }
+    if (op >= opEnd)
+        return nullptr;
+    (*op++) = uint8_t(length);
+    return op;
+}
+//==============================================================================
+size_t Compression::Bound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+//------------------------------------------------------------------------------
+size_t Compression::Compress(void const* source, size_t sourceSize, void* target, size_t targetCapacity)
+{
+    uint8_t const* src = (uint8_t const*)source;
+    uint8_t const* end = src + sourceSize;
+    uint8_t const* ip = src;
+    uint8_t const* anchor = src;
+    uint8_t* op = (uint8_t*)target;
+    uint8_t* opEnd = op + targetCapacity;
+
+    auto sequence = [&](uint8_t const* literal, size_t literalLength, size_t offset, size_t matchLength)
+    {
+        if (op >= opEnd)
+            return false;
+        uint8_t* token = op++;
+        (*token) = uint8_t(std::min<size_t>(literalLength, 15) << 4);
+        if (literalLength >= 15 && (op = WriteLength(op, opEnd, literalLength - 15)) == nullptr)
+            return false;
+        if (size_t(opEnd - op) < literalLength)
+            return false;
+        memcpy(op, literal, literalLength);
+        op += literalLength;
+        if (matchLength == 0)
+            return true;
+        if (opEnd - op < 2)
+            return false;
+        (*op++) = uint8_t(offset);
+        (*op++) = uint8_t(offset >> 8);
+        matchLength -= MINMATCH;
+        (*token) |= uint8_t(std::min<size_t>(matchLength, 15));
+        if (matchLength >= 15 && (op = WriteLength(op, opEnd, matchLength - 15)) == nullptr)
+            return false;
+        return true;
+    };
+
+    if (sourceSize > MFLIMIT)
+    {
+        std::vector<uint32_t> table(size_t(1) << HASHLOG);
+        uint8_t const* limit = end - MFLIMIT;
+        uint8_t const* matchLimit = end - LASTLITERALS;
+        size_t attempts = 0;
+
+        ip++;
+        while (ip < limit)
+        {
+            uint32_t value = Read32(ip);
+            uint32_t& slot = table[Hash32(value)];
+            uint8_t const* ref = src + slot;
+            slot = uint32_t(ip - src);
+            if (ref >= ip || size_t(ip - ref) > MAXDISTANCE || Read32(ref) != value)
+            {
+                ip += 1 + (attempts++ >> 6);
+                continue;
+            }
+            attempts = 0;
+
+            while (ip > anchor && ref > src && ip[-1] == ref[-1])
+            {
+                ip--;
+                ref--;
+            }
+            size_t length = MINMATCH;
+            while (ip + length < matchLimit && ip[length] == ref[length])
+            {
+                length++;
+            }
+            if (sequence(anchor, ip - anchor, ip - ref, length) == false)
+                return 0;
+            ip += length;
+            anchor = ip;
+
+            if (ip < limit)
+            {
+                table[Hash32(Read32(ip - 2))] = uint32_t(ip - 2 - src);
+            }
+        }
+    }
+
+    if (sequence(anchor, end - anchor, 0, 0) == false)
+        return 0;
+    return op - (uint8_t*)target;
+}
+//------------------------------------------------------------------------------
+size_t Compression::Decompress(void const* source, size_t sourceSize, void* target, size_t targetSize)
+{
+    uint8_t const* ip = (uint8_t const*)source;
+    uint8_t const* ipEnd = ip + sourceSize;
+    uint8_t* op = (uint8_t*)target;
+    uint8_t* opBegin = op;
+    uint8_t* opEnd = op + targetSize;
+
+    auto extend = [&](size_t& length)
+    {
+        uint8_t byte;
+        do
+        {
+            if (ip >= ipEnd)
+                return false;
+            byte = (*ip++);
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (ip < ipEnd)
+    {
+        uint8_t token = (*ip++);
+
+        // Literal
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && extend(literalLength) == false)
+            return 0;
+        if (size_t(ipEnd - ip) < literalLength || size_t(opEnd - op) < literalLength)
+            return 0;
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+        if (ip >= ipEnd)
+            break;
+
+        // Match
+        if (ipEnd - ip < 2)
+            return 0;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > size_t(op - opBegin))
+            return 0;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && extend(matchLength) == false)
+            return 0;
+        matchLength += MINMATCH;
+        if (size_t(opEnd - op) < matchLength)
+            return 0;
+        uint8_t const* match = op - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else if (offset >= 8)
+        {
+            for (; matchLength >= 8; matchLength -= 8, op += 8, match += 8)
+                memcpy(op, match, 8);
+            for (; matchLength; --matchLength)
+                (*op++) = (*match++);
+        }
+        else
+        {
+            for (; matchLength; --matchLength)
+                (*op++) = (*match++);
+        }
+    }
+
+    return op - opBegin;
+}
+//==============================================================================
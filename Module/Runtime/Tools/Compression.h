@@ -0,0 +1,17 @@
+//==============================================================================
+// Minamoto : Compression Header
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#pragma once
+
+#include "Runtime.h"
+
+// LZ4 block format
+struct RuntimeAPI Compression
+{
+    static size_t Bound(size_t size);
+    static size_t Compress(void const* source, size_t sourceSize, void* target, size_t targetCapacity);
+    static size_t Decompress(void const* source, size_t sourceSize, void* target, size_t targetSize);
+};
@@ -5,14 +5,22 @@
 // https://github.com/NyankoLab/Minamoto
 //==============================================================================
 #include "Runtime.h"
+#include <algorithm>
 #include "Graphic/Camera.h"
+#include "Graphic/Material.h"
 #include "Graphic/Mesh.h"
 #include "Graphic/Node.h"
+#include "Graphic/Texture.h"
 #if HAVE_MINIGUI
 #include "MiniGUI/Window.h"
 #endif
+#include "BVH.h"
 #include "DrawTools.h"
 
+//==============================================================================
+static std::vector<Node*> drawNodes;
+static std::vector<std::pair<uint64_t, Node*>> sortNodes;
+static std::vector<std::pair<uint64_t, Node*>> sortTemps;
 //==============================================================================
 void DrawTools::Cull(xxNodePtr const& node, xxCameraPtr const& camera, std::vector<Node*>& scene, std::vector<Node*>* gui, bool append)
 {
@@ -48,6 +56,40 @@ void DrawTools::Cull(xxNodePtr const& node, xxCameraPtr const& camera, std::vect
     }
 }
 //------------------------------------------------------------------------------
+void DrawTools::Cull(BVH const& bvh, xxNodePtr const& node, xxCameraPtr const& camera, std::vector<Node*>& scene, std::vector<Node*>* gui, bool append)
+{
+    if (append == false)
+    {
+        scene.clear();
+        if (gui)
+        {
+            gui->clear();
+        }
+    }
+
+    xxMatrix4x2 frustum[6];
+    if (camera)
+    {
+        camera->GetFrustumPlanes(frustum[0], frustum[1], frustum[2], frustum[3], frustum[4], frustum[5]);
+    }
+
+#if HAVE_MINIGUI
+    if (gui)
+    {
+        for (xxNodePtr const& child : (*node))
+        {
+            auto& window = MiniGUI::Window::Cast(child);
+            if (window)
+            {
+                CullTraversal(child, frustum, *gui, 0);
+            }
+        }
+    }
+#endif
+
+    bvh.Cull(camera ? frustum : nullptr, scene);
+}
+//------------------------------------------------------------------------------
 void DrawTools::Draw(DrawData& drawData, xxNodePtr const& node)
 {
     xxMatrix4x2 frustum[6];
@@ -61,12 +103,23 @@ void DrawTools::Draw(DrawData& drawData, xxNodePtr const& node)
         }
     }
 
+    drawNodes.clear();
     if (node->Mesh)
-        node->Draw(drawData);
-
+        drawNodes.push_back(node.get());
     for (xxNodePtr const& child : (*node))
     {
 #if HAVE_MINIGUI
+        if (MiniGUI::Window::Cast(child))
+            continue;
+#endif
+        DrawTraversal(child, drawNodes);
+    }
+    Sort(drawData, drawNodes);
+    Draw(drawData, drawNodes);
+
+#if HAVE_MINIGUI
+    for (xxNodePtr const& child : (*node))
+    {
         auto& window = MiniGUI::Window::Cast(child);
         if (window)
         {
@@ -74,10 +127,164 @@ void DrawTools::Draw(DrawData& drawData, xxNodePtr const& node)
             drawData.camera = drawData.camera2D.get();
             DrawTraversal(drawData, window);
             drawData.camera = camera;
-            continue;
         }
+    }
 #endif
-        DrawTraversal(drawData, child);
+}
+//------------------------------------------------------------------------------
+void DrawTools::Draw(DrawData& drawData, std::vector<Node*> const& nodes)
+{
+    Material::InstanceDrawData instanceData;
+    static_cast<xxDrawData&>(instanceData) = drawData;
+    instanceData.materialIndex = drawData.materialIndex | Material::INSTANCE;
+
+    // Merge adjacent nodes sharing mesh and material
+    size_t end = 0;
+    for (size_t begin = 0; begin < nodes.size(); begin = end)
+    {
+        Node* node = nodes[begin];
+        xxMaterialPtr const& material = node->Material ? node->Material : Material::DefaultMaterial;
+        drawData.mesh = node->Mesh.get();
+        drawData.node = node;
+        end = begin + 1;
+        if (material->Instancing(drawData))
+        {
+            for (; end < nodes.size() && end - begin < size_t(Material::MaxInstanceCount); ++end)
+            {
+                Node* other = nodes[end];
+                if (other->Mesh != node->Mesh || other->Material != node->Material)
+                    break;
+                drawData.node = other;
+                if (material->Instancing(drawData) == false)
+                    break;
+            }
+        }
+        int count = int(end - begin);
+        if (count == 1)
+        {
+            node->Draw(drawData);
+            continue;
+        }
+
+        instanceData.mesh = node->Mesh.get();
+        instanceData.node = node;
+        instanceData.instanceNodes = nodes.data() + begin;
+        instanceData.instanceCount = count;
+
+        node->Mesh->Setup(instanceData.device);
+        material->Setup(instanceData);
+        if (instanceData.constantData->ready <= 0)
+        {
+            for (size_t i = begin; i < end; ++i)
+                nodes[i]->Draw(drawData);
+            continue;
+        }
+
+        material->Draw(instanceData);
+        node->Mesh->Draw(instanceData.commandEncoder, count);
+    }
+}
+//------------------------------------------------------------------------------
+void DrawTools::Sort(DrawData const& drawData, std::vector<Node*>& nodes)
+{
+    if (nodes.empty())
+        return;
+
+    auto hash = [](uint64_t value, int bits)
+    {
+        return (value * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+    };
+
+    xxCamera* camera = drawData.camera;
+    size_t constantIndex = Material::GetConstantIndex(drawData.materialIndex);
+
+    sortNodes.resize(nodes.size());
+    sortTemps.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        Node* node = nodes[i];
+        xxMaterialPtr const& material = node->Material ? node->Material : Material::DefaultMaterial;
+
+        uint64_t pipeline = 0;
+        if (node->ConstantDatas.size() > constantIndex)
+            pipeline = node->ConstantDatas[constantIndex].pipeline;
+        xxTexture* texture = nullptr;
+        if (material->Textures.empty() == false)
+            texture = material->Textures.front().get();
+
+        // Positive floats keep their order as integers
+        float depth = 0.0f;
+        if (camera)
+            depth = std::max(0.0f, (node->WorldBound.xyz - camera->Location).Dot(camera->Direction));
+        uint32_t depthBits;
+        memcpy(&depthBits, &depth, sizeof(uint32_t));
+        depthBits >>= 16;
+
+        uint64_t state = 0;
+        state |= hash(pipeline, 11) << 36;
+        state |= hash(uintptr_t(material.get()), 12) << 24;
+        state |= hash(uintptr_t(node->Mesh.get()), 12) << 12;
+        state |= hash(uintptr_t(texture), 12);
+
+        // Opaque   : 0 | state (47) | front-to-back depth (16)
+        // Blending : 1 | back-to-front depth (16) | state (47)
+        uint64_t key;
+        if (material->Blending)
+        {
+            key = (1ull << 63) | (uint64_t(0xFFFF - depthBits) << 47) | state;
+        }
+        else
+        {
+            key = (state << 16) | depthBits;
+        }
+        sortNodes[i] = {key, node};
+    }
+
+    // LSD radix sort
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t counts[256] = {};
+        for (auto const& [key, node] : sortNodes)
+            counts[(key >> shift) & 0xFF]++;
+        if (counts[(sortNodes.front().first >> shift) & 0xFF] == sortNodes.size())
+            continue;
+        size_t offset = 0;
+        for (size_t& count : counts)
+        {
+            size_t next = offset + count;
+            count = offset;
+            offset = next;
+        }
+        for (auto const& pair : sortNodes)
+            sortTemps[counts[(pair.first >> shift) & 0xFF]++] = pair;
+        sortNodes.swap(sortTemps);
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        nodes[i] = sortNodes[i].second;
+    }
+}
+//------------------------------------------------------------------------------
+void DrawTools::Stream(DrawData const& drawData, std::vector<Node*> const& nodes, float height)
+{
+    if (Texture::IsStreaming() == false || drawData.camera3D == nullptr)
+        return;
+
+    // Projected diameter in pixels
+    xxCameraPtr const& camera = drawData.camera3D;
+    float scale = fabsf(camera->ProjectionMatrix[1].y) * height;
+    for (Node* node : nodes)
+    {
+        if (node->Material == nullptr)
+            continue;
+        xxVector4 const& bound = node->WorldBound;
+        float depth = camera->Direction.Dot(bound.xyz - camera->Location);
+        float pixel = (depth > bound.radius) ? bound.radius * scale / depth : FLT_MAX;
+        for (xxTexturePtr const& texture : node->Material->Textures)
+        {
+            Texture::Stream(texture, pixel);
+        }
     }
 }
 //------------------------------------------------------------------------------
@@ -119,4 +326,14 @@ void DrawTools::DrawTraversal(DrawData& drawData, xxNodePtr const& node)
     for (xxNodePtr const& child : (*node))
         DrawTraversal(drawData, child);
 }
+//------------------------------------------------------------------------------
+void DrawTools::DrawTraversal(xxNodePtr const& node, std::vector<Node*>& array)
+{
+    if (node == nullptr)
+        return;
+    if (node->Mesh)
+        array.push_back(node.get());
+    for (xxNodePtr const& child : (*node))
+        DrawTraversal(child, array);
+}
 //==============================================================================
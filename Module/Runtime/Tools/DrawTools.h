@@ -6,6 +6,8 @@
 //==============================================================================
 #pragma once
 
+class BVH;
+
 struct RuntimeAPI DrawTools
 {
     struct DrawData : public xxDrawData
@@ -15,8 +17,13 @@ struct RuntimeAPI DrawTools
     };
 
     static void Cull(xxNodePtr const& node, xxCameraPtr const& camera, std::vector<Node*>& scene, std::vector<Node*>* gui = nullptr, bool append = false);
+    static void Cull(BVH const& bvh, xxNodePtr const& node, xxCameraPtr const& camera, std::vector<Node*>& scene, std::vector<Node*>* gui = nullptr, bool append = false);
     static void Draw(DrawData& drawData, xxNodePtr const& node);
+    static void Draw(DrawData& drawData, std::vector<Node*> const& nodes);
+    static void Sort(DrawData const& drawData, std::vector<Node*>& nodes);
+    static void Stream(DrawData const& drawData, std::vector<Node*> const& nodes, float height);
 protected:
     static void CullTraversal(xxNodePtr const& node, xxMatrix4x2 const frustum[6], std::vector<Node*>& array, char planes);
     static void DrawTraversal(DrawData& drawData, xxNodePtr const& node);
+    static void DrawTraversal(xxNodePtr const& node, std::vector<Node*>& array);
 };
@@ -0,0 +1,168 @@
+//==============================================================================
+// Minamoto : JobSystem Source
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#include "Runtime.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "JobSystem.h"
+
+//==============================================================================
+struct Job
+{
+    std::function<void(size_t begin, size_t end)> const* function;
+    size_t begin;
+    size_t end;
+    std::atomic<size_t>* remaining;
+};
+struct JobQueue
+{
+    std::mutex mutex;
+    std::deque<Job> jobs;
+};
+//------------------------------------------------------------------------------
+static std::vector<std::thread> threads;
+static std::unique_ptr<JobQueue[]> queues;
+static size_t queueCount;
+static std::atomic<size_t> pending;
+static std::atomic<bool> running;
+static std::mutex sleepMutex;
+static std::condition_variable sleepCondition;
+static thread_local size_t queueIndex;
+//------------------------------------------------------------------------------
+static bool Pop(size_t index, Job& job)
+{
+    // Owner takes the newest job
+    JobQueue& own = queues[index];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.jobs.empty() == false)
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            pending--;
+            return true;
+        }
+    }
+
+    // Thief takes the oldest job
+    for (size_t i = 1; i < queueCount; ++i)
+    {
+        JobQueue& other = queues[(index + i) % queueCount];
+        std::unique_lock<std::mutex> lock(other.mutex, std::try_to_lock);
+        if (lock.owns_lock() && other.jobs.empty() == false)
+        {
+            job = other.jobs.front();
+            other.jobs.pop_front();
+            pending--;
+            return true;
+        }
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+static void Execute(Job const& job)
+{
+    (*job.function)(job.begin, job.end);
+    job.remaining->fetch_sub(1, std::memory_order_release);
+}
+//------------------------------------------------------------------------------
+static void Worker(size_t index)
+{
+    queueIndex = index;
+    while (running)
+    {
+        Job job;
+        if (Pop(index, job))
+        {
+            Execute(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [] { return pending != 0 || running == false; });
+    }
+}
+//==============================================================================
+void JobSystem::Initialize(int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = std::max<int>(std::thread::hardware_concurrency(), 1);
+    if (queues && queueCount == size_t(threadCount))
+        return;
+    Shutdown();
+
+    queueCount = threadCount;
+    queues = std::unique_ptr<JobQueue[]>(new JobQueue[queueCount]);
+    running = true;
+    for (size_t i = 1; i < queueCount; ++i)
+    {
+        threads.emplace_back(Worker, i);
+    }
+}
+//------------------------------------------------------------------------------
+void JobSystem::Shutdown()
+{
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_all();
+    for (std::thread& thread : threads)
+        thread.join();
+    threads.clear();
+    queues = nullptr;
+    queueCount = 0;
+    pending = 0;
+}
+//------------------------------------------------------------------------------
+int JobSystem::ThreadCount()
+{
+    return int(threads.size() + 1);
+}
+//------------------------------------------------------------------------------
+void JobSystem::ParallelFor(size_t count, size_t batch, std::function<void(size_t begin, size_t end)> const& function)
+{
+    if (count == 0)
+        return;
+    batch = std::max<size_t>(batch, 1);
+    size_t jobCount = (count + batch - 1) / batch;
+    if (threads.empty() || jobCount == 1)
+    {
+        function(0, count);
+        return;
+    }
+
+    std::atomic<size_t> remaining = jobCount;
+    JobQueue& queue = queues[queueIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t begin = 0; begin < count; begin += batch)
+        {
+            queue.jobs.push_back({ &function, begin, std::min(begin + batch, count), &remaining });
+        }
+        pending += jobCount;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_all();
+
+    // Help until every batch of this call is done
+    while (remaining.load(std::memory_order_acquire))
+    {
+        Job job;
+        if (Pop(queueIndex, job))
+        {
+            Execute(job);
+            continue;
+        }
+        std::this_thread::yield();
+    }
+}
+//==============================================================================
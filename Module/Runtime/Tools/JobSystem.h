@@ -0,0 +1,19 @@
+//==============================================================================
+// Minamoto : JobSystem Header
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#pragma once
+
+#include "Runtime.h"
+#include <functional>
+
+// Work-stealing thread pool, the calling thread always takes part
+struct RuntimeAPI JobSystem
+{
+    static void Initialize(int threadCount = 0);
+    static void Shutdown();
+    static int  ThreadCount();
+    static void ParallelFor(size_t count, size_t batch, std::function<void(size_t begin, size_t end)> const& function);
+};
@@ -6,9 +6,11 @@
 //==============================================================================
 #include "Runtime.h"
 #include "Graphic/Node.h"
+#include "Modifier/Modifier.h"
 #if HAVE_MINIGUI
 #include "MiniGUI/Window.h"
 #endif
+#include "JobSystem.h"
 #include "NodeTools.h"
 
 //==============================================================================
@@ -48,21 +50,11 @@ xxNodePtr const& NodeTools::GetRoot(xxNodePtr const& node)
     return (*root);
 }
 //------------------------------------------------------------------------------
-xxNodePtr const& NodeTools::GetObject(xxNodePtr const& node, std::string const& name)
+xxNodePtr NodeTools::GetObject(xxNodePtr const& node, std::string const& name)
 {
-    xxNodePtr const* output = nullptr;
-    Node::Traversal(node, [&](xxNodePtr const& node)
-    {
-        if (node->Name == name)
-            output = &node;
-        return output ? -1 : 1;
-    });
-    if (output == nullptr)
-    {
-        static xxNodePtr empty;
-        return empty;
-    }
-    return (*output);
+    if (node == nullptr)
+        return nullptr;
+    return node->FindObject(name);
 }
 //------------------------------------------------------------------------------
 xxNodePtr const& NodeTools::Intersect(xxNodePtr const& node, xxVector3 const& position, xxVector3 const& direction)
@@ -162,43 +154,64 @@ void NodeTools::ConvertQuadTree(xxNodePtr const& node)
 //------------------------------------------------------------------------------
 void NodeTools::RemoveEmptyNode(xxNodePtr const& node)
 {
-    std::vector<xxNodePtr> children;
-    for (xxNodePtr const& child : (*node))
-    {
-        children.push_back(child);
-    }
-    node->RemoveAllChildren();
+    // Copy because the topology changes below
+    std::vector<Node::Linear> array = Node::Flatten(node.get());
+    std::vector<char> removed(array.size());
 
-    for (xxNodePtr const& child : children)
+    // Children are filtered from the top before their own children change
+    for (size_t i = 0; i < array.size(); ++i)
     {
-        if (child->Mesh || child->GetChildCount())
+        if (removed[i])
+            continue;
+        Node* node = array[i].node;
+
+        std::vector<xxNodePtr> children;
+        for (xxNodePtr const& child : (*node))
         {
-            node->AttachChild(child);
+            children.push_back(child);
         }
-    }
+        node->RemoveAllChildren();
 
-    for (xxNodePtr const& child : (*node))
-    {
-        RemoveEmptyNode(child);
+        uint32_t index = uint32_t(i + 1);
+        for (xxNodePtr const& child : children)
+        {
+            if (child->Mesh || child->GetChildCount())
+            {
+                node->AttachChild(child);
+            }
+            else
+            {
+                std::fill(removed.begin() + index, removed.begin() + array[index].next, 1);
+            }
+            index = array[index].next;
+        }
     }
 
-    if (node->GetChildCount() == 1)
+    // Single empty children are collapsed from the bottom
+    for (size_t i = array.size(); i > 0; --i)
     {
-        xxNodePtr child = node->GetChild(0);
-        if (child->Mesh == nullptr)
-        {
-            node->RemoveAllChildren();
+        if (removed[i - 1])
+            continue;
+        Node* node = array[i - 1].node;
 
-            std::vector<xxNodePtr> grandChildren;
-            for (xxNodePtr const& grandChild : (*child))
+        if (node->GetChildCount() == 1)
+        {
+            xxNodePtr child = node->GetChild(0);
+            if (child->Mesh == nullptr)
             {
-                grandChildren.push_back(grandChild);
-            }
-            child->RemoveAllChildren();
+                node->RemoveAllChildren();
 
-            for (xxNodePtr const& child : grandChildren)
-            {
-                node->AttachChild(child);
+                std::vector<xxNodePtr> grandChildren;
+                for (xxNodePtr const& grandChild : (*child))
+                {
+                    grandChildren.push_back(grandChild);
+                }
+                child->RemoveAllChildren();
+
+                for (xxNodePtr const& child : grandChildren)
+                {
+                    node->AttachChild(child);
+                }
             }
         }
     }
@@ -217,7 +230,7 @@ void NodeTools::ResetBoneMatrix(xxNodePtr const& node)
         return { tangent0, -normal, tangent1 };
     };
 
-    Node::Traversal(node, [&](xxNodePtr const& node)
+    Node::Visit(node, [&](Node* node)
     {
         xxNodePtr const& parent = node->GetParent();
         if (parent == nullptr)
@@ -253,7 +266,7 @@ void NodeTools::ResetBoneMatrix(xxNodePtr const& node)
         return true;
     });
 
-    Node::Traversal(node, [&](xxNodePtr const& node)
+    Node::Visit(node, [&](Node* node)
     {
         xxMeshPtr const& mesh = node->Mesh;
         if (mesh == nullptr)
@@ -272,7 +285,7 @@ void NodeTools::ResetBoneMatrix(xxNodePtr const& node)
 //------------------------------------------------------------------------------
 void NodeTools::UpdateNodeFlags(xxNodePtr const& node)
 {
-    Node::Traversal(node, [](xxNodePtr const& node)
+    Node::Visit(node, [](Node* node)
     {
         node->Flags |= xxNode::UPDATE_SKIP;
         for (auto const& data : node->Bones)
@@ -296,18 +309,216 @@ void NodeTools::UpdateNodeFlags(xxNodePtr const& node)
         return true;
     });
 
-    Node::Traversal(node, [](xxNodePtr const& node)
+    Node::Visit(node, [](Node* node)
     {
         if (node->Flags & xxNode::UPDATE_NEED)
         {
-            xxNodePtr parent = node;
+            Node* parent = node;
             while (parent && (parent->Flags & xxNode::UPDATE_SKIP))
             {
                 parent->Flags &= ~xxNode::UPDATE_SKIP;
-                parent = parent->GetParent();
+                parent = parent->GetParent().get();
             }
         }
         return true;
     });
 }
+//------------------------------------------------------------------------------
+static void MultiplyMatrix(xxMatrix4& output, xxMatrix4 const& parent, xxMatrix4 const& local)
+{
+    v4sf p0 = parent.v[0].v;
+    v4sf p1 = parent.v[1].v;
+    v4sf p2 = parent.v[2].v;
+    v4sf p3 = parent.v[3].v;
+    xxVector4 const* l = local.v;
+
+    // 4x3 when the local matrix is affine, the missing term only adds zero
+    if (l[0].w == 0.0f && l[1].w == 0.0f && l[2].w == 0.0f)
+    {
+        output.v[0].v = p0 * l[0].x + p1 * l[0].y + p2 * l[0].z;
+        output.v[1].v = p0 * l[1].x + p1 * l[1].y + p2 * l[1].z;
+        output.v[2].v = p0 * l[2].x + p1 * l[2].y + p2 * l[2].z;
+        output.v[3].v = p0 * l[3].x + p1 * l[3].y + p2 * l[3].z + p3 * l[3].w;
+        return;
+    }
+    output.v[0].v = p0 * l[0].x + p1 * l[0].y + p2 * l[0].z + p3 * l[0].w;
+    output.v[1].v = p0 * l[1].x + p1 * l[1].y + p2 * l[1].z + p3 * l[1].w;
+    output.v[2].v = p0 * l[2].x + p1 * l[2].y + p2 * l[2].z + p3 * l[2].w;
+    output.v[3].v = p0 * l[3].x + p1 * l[3].y + p2 * l[3].z + p3 * l[3].w;
+}
+//------------------------------------------------------------------------------
+static void PropagateWorldMatrix(Node* node, size_t skipFlags, size_t dirtyFlags)
+{
+    std::vector<Node::Linear> const& array = Node::Flatten(node);
+    size_t count = array.size();
+
+    // Parents come first in depth-first order, so each dirty subtree is one range
+    for (size_t i = 0; i < count;)
+    {
+        Node* node = array[i].node;
+        if (node->Flags & skipFlags)
+        {
+            i = array[i].next;
+            continue;
+        }
+        if (dirtyFlags && (node->Flags & dirtyFlags) == 0)
+        {
+            i++;
+            continue;
+        }
+
+        size_t end = array[i].next;
+        while (i < end)
+        {
+            Node::Linear const& linear = array[i];
+            Node* node = linear.node;
+            if (node->Flags & skipFlags)
+            {
+                i = linear.next;
+                continue;
+            }
+            node->Flags &= ~dirtyFlags;
+
+            Node* parent = linear.parent != UINT32_MAX ? array[linear.parent].node : node->GetParent().get();
+            if (parent)
+                MultiplyMatrix(node->WorldMatrix, parent->WorldMatrix, node->LocalMatrix);
+            else
+                node->WorldMatrix = node->LocalMatrix;
+            i++;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+static void UpdateBoneMatrix(Node* node, size_t skipFlags)
+{
+    std::vector<Node::Linear> const& array = Node::Flatten(node);
+    size_t count = array.size();
+
+    // Bones may follow the skin in depth-first order, so this runs after the propagation
+    for (size_t i = 0; i < count;)
+    {
+        Node* node = array[i].node;
+        if (node->Flags & skipFlags)
+        {
+            i = array[i].next;
+            continue;
+        }
+        for (auto& data : node->Bones)
+        {
+            if (data.bone.use_count())
+            {
+                xxNodePtr const& bone = (xxNodePtr&)data.bone;
+                data.boneMatrix = bone->WorldMatrix * data.skinMatrix;
+            }
+        }
+        i++;
+    }
+}
+//------------------------------------------------------------------------------
+void NodeTools::UpdateWorldMatrix(xxNodePtr const& node, size_t skipFlags, size_t dirtyFlags)
+{
+    PropagateWorldMatrix(node.get(), skipFlags, dirtyFlags);
+}
+//------------------------------------------------------------------------------
+static std::vector<Node*> parallelModifierNodes;
+static std::vector<Node*> serialModifierNodes;
+//------------------------------------------------------------------------------
+static bool CollectModifier(Node* node, Node* root)
+{
+    if (node->Flags & xxNode::UPDATE_SKIP)
+        return true;
+
+    if (node->Modifiers.empty() == false)
+    {
+        // Particle modifiers write into the shared parameter and mesh
+        if (node->Flags & Node::PARTICLE)
+            serialModifierNodes.push_back(node);
+        else
+            parallelModifierNodes.push_back(node);
+    }
+
+    // Bones outside the subtree make the subtrees dependent
+    bool independent = true;
+    for (auto const& data : node->Bones)
+    {
+        xxNode* bone = ((xxNodePtr&)data.bone).get();
+        while (bone && bone != root)
+            bone = bone->GetParent().get();
+        if (bone == nullptr)
+            independent = false;
+    }
+
+    for (xxNodePtr const& child : (*node))
+    {
+        independent &= CollectModifier(child.get(), root);
+    }
+    return independent;
+}
+//------------------------------------------------------------------------------
+static void UpdateModifier(Node* node, float time)
+{
+    for (xxModifierData& data : node->Modifiers)
+    {
+        data.modifier->Update(node, time, &data);
+    }
+}
+//------------------------------------------------------------------------------
+void NodeTools::Update(std::vector<Node*> const& nodes, float time)
+{
+    parallelModifierNodes.clear();
+    serialModifierNodes.clear();
+    bool independent = true;
+    for (Node* node : nodes)
+    {
+        independent &= CollectModifier(node, node);
+    }
+
+    // Modifiers only write into their own node and modifier data, the channels
+    // of a range are sampled together so clips shared by a crowd are searched once
+    JobSystem::ParallelFor(parallelModifierNodes.size(), 64, [time](size_t begin, size_t end)
+    {
+        void* targets[256];
+        xxModifierData* data[256];
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            Node* node = parallelModifierNodes[i];
+            for (xxModifierData& modifierData : node->Modifiers)
+            {
+                if (count == xxCountOf(data))
+                {
+                    Modifier::UpdateBatch(targets, data, count, time);
+                    count = 0;
+                }
+                targets[count] = node;
+                data[count] = &modifierData;
+                count++;
+            }
+        }
+        Modifier::UpdateBatch(targets, data, count, time);
+    });
+    for (Node* node : serialModifierNodes)
+    {
+        UpdateModifier(node, time);
+    }
+
+    // World matrices are propagated inside each subtree in the same order as
+    // the serial path, only the ranges below nodes marked dirty are recomputed
+    if (independent == false)
+    {
+        for (Node* node : nodes)
+            PropagateWorldMatrix(node, xxNode::UPDATE_SKIP, Node::UPDATE_DIRTY);
+        for (Node* node : nodes)
+            UpdateBoneMatrix(node, xxNode::UPDATE_SKIP);
+        return;
+    }
+    JobSystem::ParallelFor(nodes.size(), 1, [&nodes](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            PropagateWorldMatrix(nodes[i], xxNode::UPDATE_SKIP, Node::UPDATE_DIRTY);
+            UpdateBoneMatrix(nodes[i], xxNode::UPDATE_SKIP);
+        }
+    });
+}
 //==============================================================================
@@ -15,10 +15,12 @@ struct RuntimeAPI NodeTools
     static MiniGUI::WindowPtr const& GetRoot(MiniGUI::WindowPtr const& window);
 #endif
     static xxNodePtr const& GetRoot(xxNodePtr const& node);
-    static xxNodePtr const& GetObject(xxNodePtr const& node, std::string const& name);
+    static xxNodePtr GetObject(xxNodePtr const& node, std::string const& name);
     static xxNodePtr const& Intersect(xxNodePtr const& node, xxVector3 const& position, xxVector3 const& direction);
     static void ConvertQuadTree(xxNodePtr const& node);
     static void RemoveEmptyNode(xxNodePtr const& node);
     static void ResetBoneMatrix(xxNodePtr const& node);
     static void UpdateNodeFlags(xxNodePtr const& node);
+    static void UpdateWorldMatrix(xxNodePtr const& node, size_t skipFlags = xxNode::UPDATE_SKIP, size_t dirtyFlags = 0);
+    static void Update(std::vector<Node*> const& nodes, float time);
 };
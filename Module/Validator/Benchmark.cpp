@@ -0,0 +1,944 @@
+//==============================================================================
+// Minamoto : Benchmark Source
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#include <Runtime.h>
+#include <algorithm>
+#include <string>
+#include <xxGraphicPlus/xxFile.h>
+#include <Graphic/Binary.h>
+#include <Graphic/Camera.h>
+#include <Graphic/Mesh.h>
+#include <Graphic/Node.h>
+#include <Modifier/Baked/BakedQuaternionModifier.h>
+#include <Modifier/Baked/BakedQuaternion16Modifier.h>
+#include <Modifier/Baked/BakedQuaternion48Modifier.h>
+#include <Modifier/Interpolated/InterpolatedQuaternionModifier.h>
+#include <Modifier/Interpolated/InterpolatedTranslateModifier.h>
+#include <Modifier/Modifier.inl>
+#include <Tools/BVH.h>
+#include <Tools/Compression.h>
+#include <Tools/DrawTools.h>
+#include <Tools/JobSystem.h>
+#include <Tools/NodeTools.h>
+#include "Benchmark.h"
+
+static int const CROWD_COUNT = 256;
+static int const BONE_COUNT = 48;
+static int const KEY_COUNT = 30;
+static int const FRAME_COUNT = 60;
+static int const GROUP_COUNT = 1000;
+static int const GROUP_SIZE = 100;
+static int const LOOKUP_COUNT = 256;
+static int const TRAVERSAL_COUNT = 100000;
+static int const CHANNEL_COUNT = 64;
+static int const ROTATION_COUNT = 3000;
+static int const COMPRESSION_SIZE = 4 * 1024 * 1024;
+
+//------------------------------------------------------------------------------
+static xxNodePtr CreateCrowd()
+{
+    std::vector<xxModifierPtr> rotates;
+    std::vector<xxModifierPtr> translates;
+    for (int i = 0; i < BONE_COUNT; ++i)
+    {
+        rotates.push_back(InterpolatedQuaternionModifier::Create(KEY_COUNT, [i](size_t index, float& time, xxVector4& quaternion)
+        {
+            float angle = (index + i) * 0.1f;
+            time = index / 30.0f;
+            quaternion = { 0.0f, sinf(angle), 0.0f, cosf(angle) };
+        }));
+        translates.push_back(InterpolatedTranslateModifier::Create(KEY_COUNT, [i](size_t index, float& time, xxVector3& translate)
+        {
+            time = index / 30.0f;
+            translate = { 0.0f, 1.0f + index * 0.01f, i * 0.001f };
+        }));
+    }
+
+    xxNodePtr root = xxNode::Create();
+    for (int i = 0; i < CROWD_COUNT; ++i)
+    {
+        xxNodePtr character = xxNode::Create();
+        character->SetTranslate({ float(i % 16), 0.0f, float(i / 16) });
+        character->UpdateRotateTranslateScale();
+        root->AttachChild(character);
+
+        // Skeleton as a binary tree
+        std::vector<xxNodePtr> bones;
+        for (int j = 0; j < BONE_COUNT; ++j)
+        {
+            xxNodePtr bone = xxNode::Create();
+            bone->Modifiers.emplace_back(rotates[j]);
+            bone->Modifiers.emplace_back(translates[j]);
+            (j ? bones[(j - 1) / 2] : character)->AttachChild(bone);
+            bones.push_back(bone);
+        }
+
+        // Skin
+        xxNodePtr skin = xxNode::Create();
+        for (xxNodePtr const& bone : bones)
+        {
+            xxNode::BoneData data;
+            data.bone = bone;
+            data.bound = xxVector4::ZERO;
+            data.classSkinMatrix = xxMatrix4::IDENTITY;
+            data.classBoneMatrix = {};
+            skin->Bones.push_back(data);
+        }
+        for (auto& data : skin->Bones)
+        {
+            data.ResetPointer();
+        }
+        character->AttachChild(skin);
+    }
+    return root;
+}
+//------------------------------------------------------------------------------
+static void Capture(xxNodePtr const& root, std::vector<xxMatrix4>& matrices)
+{
+    matrices.clear();
+    Node::Traversal(root, [&](xxNodePtr const& node)
+    {
+        matrices.push_back(node->WorldMatrix);
+        return true;
+    });
+}
+//------------------------------------------------------------------------------
+static xxNodePtr CreateField()
+{
+    xxMeshPtr mesh = xxMesh::Create(false, 0, 0, 0);
+    const_cast<xxVector4&>(mesh->Bound) = { 0.0f, 0.0f, 0.0f, 0.5f };
+
+    xxNodePtr root = xxNode::Create();
+    for (int i = 0; i < GROUP_COUNT; ++i)
+    {
+        xxNodePtr group = xxNode::Create();
+        group->SetTranslate({ float(i % 32) * 10.0f, float(i / 32) * 10.0f, 0.0f });
+        group->UpdateRotateTranslateScale();
+        root->AttachChild(group);
+        for (int j = 0; j < GROUP_SIZE; ++j)
+        {
+            xxNodePtr node = xxNode::Create();
+            node->SetTranslate({ float(j % 10), float(j / 10), 0.0f });
+            node->UpdateRotateTranslateScale();
+            node->Mesh = mesh;
+            group->AttachChild(node);
+        }
+    }
+    NodeTools::UpdateNodeFlags(root);
+    root->Update(0.0f);
+    root->UpdateBound();
+    return root;
+}
+//------------------------------------------------------------------------------
+void BenchmarkCull(char* text, size_t count)
+{
+    int step = 0;
+
+    xxNodePtr root = CreateField();
+    step += snprintf(text + step, count - step, "Field : %d x %d nodes\n", GROUP_COUNT, GROUP_SIZE);
+
+    xxCameraPtr camera = xxCamera::Create();
+    camera->Location = { -10.0f, -10.0f, 20.0f };
+    camera->LookAt({ 80.0f, 80.0f, 0.0f }, xxVector3::Z);
+    camera->SetFOV(16.0f / 9.0f, 60.0f, 10000.0f);
+    camera->Update();
+
+    double begin = 0.0;
+    double end = 0.0;
+
+    // Traversal
+    std::vector<Node*> reference;
+    xxGetCurrentTime(&begin);
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        DrawTools::Cull(root, camera, reference);
+    }
+    xxGetCurrentTime(&end);
+    step += snprintf(text + step, count - step, "Traversal : %.3fms, %zd visible\n", (end - begin) * 1000.0 / FRAME_COUNT, reference.size());
+
+    // Build
+    BVH bvh;
+    xxGetCurrentTime(&begin);
+    bvh.Build(root);
+    xxGetCurrentTime(&end);
+    step += snprintf(text + step, count - step, "BVH Build : %.3fms, %zd nodes\n", (end - begin) * 1000.0, bvh.GetNodeCount());
+
+    // Cull
+    std::vector<Node*> visible;
+    xxGetCurrentTime(&begin);
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        DrawTools::Cull(bvh, root, camera, visible);
+    }
+    xxGetCurrentTime(&end);
+    std::sort(reference.begin(), reference.end());
+    std::sort(visible.begin(), visible.end());
+    step += snprintf(text + step, count - step, "BVH Cull : %.3fms, %zd visible, %s\n", (end - begin) * 1000.0 / FRAME_COUNT, visible.size(), reference == visible ? "Match" : "Mismatch");
+
+    // Refit after moving one node of every group
+    for (xxNodePtr const& group : (*root))
+    {
+        for (xxNodePtr const& node : (*group))
+        {
+            node->SetTranslate(node->GetTranslate() + xxVector3::Z * 5.0f);
+            node->UpdateRotateTranslateScale();
+            break;
+        }
+    }
+    root->Update(0.0f);
+    root->UpdateBound();
+    xxGetCurrentTime(&begin);
+    bvh.Refit();
+    xxGetCurrentTime(&end);
+    step += snprintf(text + step, count - step, "BVH Refit : %.3fms, %zd moved\n", (end - begin) * 1000.0, bvh.GetRefitCount());
+
+    DrawTools::Cull(root, camera, reference);
+    DrawTools::Cull(bvh, root, camera, visible);
+    std::sort(reference.begin(), reference.end());
+    std::sort(visible.begin(), visible.end());
+    step += snprintf(text + step, count - step, "BVH Cull : %zd visible, %s\n", visible.size(), reference == visible ? "Match" : "Mismatch");
+}
+//------------------------------------------------------------------------------
+static xxNodePtr CreateHierarchy(int count)
+{
+    // Wide at the top, deep at the bottom like imported scenes
+    std::vector<xxNodePtr> nodes;
+    xxNodePtr root = xxNode::Create();
+    root->Name = "Root";
+    for (int i = 0; i < count; ++i)
+    {
+        xxNodePtr node = xxNode::Create();
+        node->Name = "Node" + std::to_string(i);
+        (i < 16 ? root : nodes[i < 256 ? i % 16 : (i - 1) / 4])->AttachChild(node);
+        nodes.push_back(node);
+    }
+    return root;
+}
+//------------------------------------------------------------------------------
+static xxNodePtr LinearObject(xxNodePtr const& root, std::string const& name)
+{
+    xxNodePtr output;
+    Node::Traversal(root, [&](xxNodePtr const& node)
+    {
+        if (node->Name == name)
+            output = node;
+        return output ? -1 : 1;
+    });
+    return output;
+}
+//------------------------------------------------------------------------------
+void BenchmarkObject(char* text, size_t count)
+{
+    int step = 0;
+
+    for (int nodeCount : { 1000, 10000, 100000 })
+    {
+        xxNodePtr root = CreateHierarchy(nodeCount);
+        step += snprintf(text + step, count - step, "Hierarchy : %d nodes\n", nodeCount);
+
+        std::vector<std::string> names;
+        for (int i = 0; i < LOOKUP_COUNT; ++i)
+        {
+            names.push_back("Node" + std::to_string((i * 7919) % nodeCount));
+        }
+        names.push_back("Missing");
+
+        double begin = 0.0;
+        double end = 0.0;
+
+        // Linear
+        std::vector<xxNodePtr> reference;
+        xxGetCurrentTime(&begin);
+        for (std::string const& name : names)
+        {
+            reference.push_back(LinearObject(root, name));
+        }
+        xxGetCurrentTime(&end);
+        step += snprintf(text + step, count - step, "Linear : %.3fus\n", (end - begin) * 1000000.0 / names.size());
+
+        // Index
+        xxGetCurrentTime(&begin);
+        NodeTools::GetObject(root, "Root");
+        xxGetCurrentTime(&end);
+        step += snprintf(text + step, count - step, "Index Build : %.3fms\n", (end - begin) * 1000.0);
+
+        std::vector<xxNodePtr> objects;
+        xxGetCurrentTime(&begin);
+        for (std::string const& name : names)
+        {
+            objects.push_back(NodeTools::GetObject(root, name));
+        }
+        xxGetCurrentTime(&end);
+        step += snprintf(text + step, count - step, "Index : %.3fus, %s\n", (end - begin) * 1000000.0 / names.size(), reference == objects ? "Match" : "Mismatch");
+
+        // Through a parented subtree, as MergeNode rebinds bones below the scene root
+        xxNodePtr branch = NodeTools::GetObject(root, "Node3");
+        std::vector<std::string> branchNames;
+        Node::Traversal(branch, [&](xxNodePtr const& node)
+        {
+            if (branchNames.size() < size_t(LOOKUP_COUNT))
+                branchNames.push_back(node->Name);
+            return true;
+        });
+        branchNames.push_back("Node0");
+        reference.clear();
+        xxGetCurrentTime(&begin);
+        for (std::string const& name : branchNames)
+        {
+            reference.push_back(LinearObject(branch, name));
+        }
+        xxGetCurrentTime(&end);
+        double linearTime = (end - begin) * 1000000.0 / branchNames.size();
+        objects.clear();
+        xxGetCurrentTime(&begin);
+        for (std::string const& name : branchNames)
+        {
+            objects.push_back(NodeTools::GetObject(branch, name));
+        }
+        xxGetCurrentTime(&end);
+        step += snprintf(text + step, count - step, "Subtree : Linear %.3fus, Index %.3fus, %s\n", linearTime, (end - begin) * 1000000.0 / branchNames.size(), reference == objects ? "Match" : "Mismatch");
+
+        // Move and rename a subtree, then check against the linear search again
+        xxNodePtr subtree = NodeTools::GetObject(root, "Node20");
+        xxNodePtr target = NodeTools::GetObject(root, "Node5");
+        subtree->GetParent()->DetachChild(subtree);
+        target->AttachChild(subtree);
+        NodeTools::GetObject(root, "Node100")->SetName("Renamed");
+        names.push_back("Renamed");
+        names.push_back("Node100");
+
+        bool match = true;
+        for (std::string const& name : names)
+        {
+            match &= LinearObject(root, name) == NodeTools::GetObject(root, name);
+        }
+        step += snprintf(text + step, count - step, "Index Update : %s\n", match ? "Match" : "Mismatch");
+    }
+}
+//------------------------------------------------------------------------------
+void BenchmarkTraversal(char* text, size_t count)
+{
+    int step = 0;
+
+    xxNodePtr root = CreateHierarchy(TRAVERSAL_COUNT);
+    step += snprintf(text + step, count - step, "Hierarchy : %d nodes\n", TRAVERSAL_COUNT + 1);
+
+    double begin = 0.0;
+    double end = 0.0;
+    size_t nodeCount = TRAVERSAL_COUNT + 1;
+
+    // Traversal
+    std::vector<Node*> reference;
+    Node::Traversal(root, [&](xxNodePtr const& node)
+    {
+        reference.push_back(node.get());
+        return true;
+    });
+    size_t referenceSum = 0;
+    xxGetCurrentTime(&begin);
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        Node::Traversal(root, [&](xxNodePtr const& node)
+        {
+            referenceSum += node->Flags;
+            return true;
+        });
+    }
+    xxGetCurrentTime(&end);
+    step += snprintf(text + step, count - step, "Traversal : %.3fns/node\n", (end - begin) * 1000000000.0 / FRAME_COUNT / nodeCount);
+
+    // Flatten
+    xxGetCurrentTime(&begin);
+    std::vector<Node::Linear> const& array = Node::Flatten(root.get());
+    xxGetCurrentTime(&end);
+    step += snprintf(text + step, count - step, "Flatten : %.3fms\n", (end - begin) * 1000.0);
+
+    // Visit
+    size_t visitSum = 0;
+    xxGetCurrentTime(&begin);
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        Node::Visit(root, [&](Node* node)
+        {
+            visitSum += node->Flags;
+            return true;
+        });
+    }
+    xxGetCurrentTime(&end);
+    bool match = visitSum == referenceSum && array.size() == reference.size();
+    for (size_t i = 0; match && i < array.size(); ++i)
+    {
+        match = array[i].node == reference[i];
+    }
+    step += snprintf(text + step, count - step, "Visit : %.3fns/node, %s\n", (end - begin) * 1000000000.0 / FRAME_COUNT / nodeCount, match ? "Match" : "Mismatch");
+
+    // Skipping subtrees
+    size_t referenceSkip = 0;
+    size_t visitSkip = 0;
+    Node::Traversal(root, [&](xxNodePtr const& node)
+    {
+        referenceSkip++;
+        return node->Name.back() & 1 ? 0 : 1;
+    });
+    Node::Visit(root, [&](Node* node)
+    {
+        visitSkip++;
+        return node->Name.back() & 1 ? 0 : 1;
+    });
+    step += snprintf(text + step, count - step, "Visit Skip : %zd nodes, %s\n", visitSkip, referenceSkip == visitSkip ? "Match" : "Mismatch");
+}
+//------------------------------------------------------------------------------
+static bool Exact(std::vector<xxMatrix4> const& a, std::vector<xxMatrix4> const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            xxVector4 const& l = a[i].v[j];
+            xxVector4 const& r = b[i].v[j];
+            if (l.x != r.x || l.y != r.y || l.z != r.z || l.w != r.w)
+                return false;
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+void BenchmarkMatrix(char* text, size_t count)
+{
+    int step = 0;
+
+    xxNodePtr crowd = CreateCrowd();
+    std::vector<Node*> nodes;
+    for (xxNodePtr const& node : (*crowd))
+    {
+        nodes.push_back(node.get());
+    }
+    NodeTools::Update(nodes, 1.0f);
+
+    xxNodePtr hierarchy = CreateHierarchy(TRAVERSAL_COUNT);
+    Node::Visit(hierarchy, [](Node* node)
+    {
+        float angle = node->Name.size() * 0.1f;
+        node->SetRotate(xxMatrix3::Quaternion({ 0.0f, 0.0f, sinf(angle), cosf(angle) }));
+        node->SetTranslate({ 1.0f, float(node->GetChildCount()), 0.5f });
+        node->UpdateRotateTranslateScale();
+        return true;
+    });
+
+    for (auto [name, root] : { std::pair{ "Crowd", crowd }, std::pair{ "Hierarchy", hierarchy } })
+    {
+        size_t nodeCount = Node::Flatten(root.get()).size();
+        step += snprintf(text + step, count - step, "%s : %zd nodes\n", name, nodeCount);
+
+        double begin = 0.0;
+        double end = 0.0;
+
+        // Scalar
+        std::vector<xxMatrix4> reference;
+        xxGetCurrentTime(&begin);
+        for (int i = 0; i < FRAME_COUNT; ++i)
+        {
+            Node::Visit(root, [](Node* node)
+            {
+                node->UpdateMatrix();
+                return true;
+            });
+        }
+        xxGetCurrentTime(&end);
+        Capture(root, reference);
+        step += snprintf(text + step, count - step, "Scalar : %.3fns/node\n", (end - begin) * 1000000000.0 / FRAME_COUNT / nodeCount);
+
+        // Batched
+        std::vector<xxMatrix4> matrices;
+        xxGetCurrentTime(&begin);
+        for (int i = 0; i < FRAME_COUNT; ++i)
+        {
+            NodeTools::UpdateWorldMatrix(root, 0);
+        }
+        xxGetCurrentTime(&end);
+        Capture(root, matrices);
+        step += snprintf(text + step, count - step, "Batched : %.3fns/node, %s\n", (end - begin) * 1000000000.0 / FRAME_COUNT / nodeCount, Exact(reference, matrices) ? "Exact" : "Mismatch");
+
+        // Dirty subtrees only
+        size_t dirtyCount = 0;
+        Node::Visit(root, [&](Node* node)
+        {
+            if (dirtyCount++ % 100 == 0)
+            {
+                node->SetTranslate(node->GetTranslate() + xxVector3::Z);
+                node->UpdateRotateTranslateScale();
+                node->Flags |= xxNode::UPDATE_NEED;
+            }
+            return true;
+        });
+        xxGetCurrentTime(&begin);
+        NodeTools::UpdateWorldMatrix(root, 0, xxNode::UPDATE_NEED);
+        xxGetCurrentTime(&end);
+        Capture(root, matrices);
+        Node::Visit(root, [](Node* node)
+        {
+            node->UpdateMatrix();
+            return true;
+        });
+        Capture(root, reference);
+        step += snprintf(text + step, count - step, "Dirty : %.3fms, %zd marked, %s\n", (end - begin) * 1000.0, (dirtyCount + 99) / 100, Exact(reference, matrices) ? "Exact" : "Mismatch");
+    }
+}
+//------------------------------------------------------------------------------
+template<class T>
+static bool LinearFactor(Modifier* modifier, xxModifierData* data, float time, T*& A, T*& B, float& F)
+{
+    if (data->time == time)
+        return false;
+    data->time = time;
+
+    if (data->start == 0.0f)
+        data->start = time;
+    time -= data->start;
+
+    auto key = (T*)modifier->Data.data();
+    auto count = modifier->Data.size() / sizeof(T);
+
+    float duration = key[count - 1].time;
+    size_t maximum = count - 2;
+    size_t index = std::min(data->index, maximum);
+    A = &key[index + 0];
+    B = &key[index + 1];
+
+    time = std::fmodf(time, duration);
+    if (A->time > time)
+    {
+        data->index = index = 0;
+        A = &key[0];
+        B = &key[1];
+        if (A->time > time)
+        {
+            return false;
+        }
+    }
+    while (B->time < time && index < maximum)
+    {
+        data->index = ++index;
+        ++A;
+        ++B;
+    }
+
+    float XY = B->time - A->time;
+    F = (time - A->time) / XY;
+    return true;
+}
+//------------------------------------------------------------------------------
+void BenchmarkSample(char* text, size_t count)
+{
+    typedef InterpolatedTranslateModifier::Key Key;
+    int step = 0;
+
+    for (int keyCount : { 30, 300, 3000, 30000 })
+    {
+        xxModifierPtr translate = InterpolatedTranslateModifier::Create(keyCount, [](size_t index, float& time, xxVector3& translate)
+        {
+            time = index / 30.0f;
+            translate = { float(index), 0.0f, 0.0f };
+        });
+        auto modifier = (Modifier*)translate.get();
+        float duration = (keyCount - 1) / 30.0f;
+        step += snprintf(text + step, count - step, "Keys : %d x %d channels\n", keyCount, CHANNEL_COUNT);
+
+        for (bool seek : { false, true })
+        {
+            std::vector<float> times;
+            unsigned int random = 1;
+            for (int i = 0; i < FRAME_COUNT; ++i)
+            {
+                random = random * 1664525 + 1013904223;
+                times.push_back(seek ? 1.0f + (random >> 8) * duration * 2.0f / (1 << 24) : 1.0f + i / 60.0f);
+            }
+
+            std::vector<xxModifierData> linearData;
+            std::vector<xxModifierData> singleData;
+            std::vector<xxModifierData> batchData;
+            for (int i = 0; i < CHANNEL_COUNT; ++i)
+            {
+                linearData.emplace_back(translate);
+                singleData.emplace_back(translate);
+                batchData.emplace_back(translate);
+            }
+            std::vector<xxModifierData*> batch;
+            for (xxModifierData& data : batchData)
+            {
+                batch.push_back(&data);
+            }
+
+            Key* A[CHANNEL_COUNT];
+            Key* B[CHANNEL_COUNT];
+            float F[CHANNEL_COUNT];
+            std::vector<float> reference;
+            std::vector<float> single;
+            std::vector<float> batched;
+            double begin = 0.0;
+            double end = 0.0;
+
+            // Linear
+            xxGetCurrentTime(&begin);
+            for (float time : times)
+            {
+                for (int i = 0; i < CHANNEL_COUNT; ++i)
+                {
+                    if (LinearFactor(modifier, &linearData[i], time, A[i], B[i], F[i]))
+                        reference.push_back(modifier->Lerp(A[i]->translate.x, B[i]->translate.x, F[i]));
+                }
+            }
+            xxGetCurrentTime(&end);
+            double linearTime = (end - begin) * 1000000000.0 / (times.size() * CHANNEL_COUNT);
+
+            // Cursor with binary search
+            xxGetCurrentTime(&begin);
+            for (float time : times)
+            {
+                for (int i = 0; i < CHANNEL_COUNT; ++i)
+                {
+                    if (modifier->UpdateInterpolatedFactor(&singleData[i], time, A[i], B[i], F[i]))
+                        single.push_back(modifier->Lerp(A[i]->translate.x, B[i]->translate.x, F[i]));
+                }
+            }
+            xxGetCurrentTime(&end);
+            double cursorTime = (end - begin) * 1000000000.0 / (times.size() * CHANNEL_COUNT);
+
+            // Batched
+            void const* batchA[CHANNEL_COUNT];
+            void const* batchB[CHANNEL_COUNT];
+            xxGetCurrentTime(&begin);
+            for (float time : times)
+            {
+                Modifier::UpdateInterpolatedFactor(batch.data(), batch.size(), time, batchA, batchB, F);
+                for (int i = 0; i < CHANNEL_COUNT; ++i)
+                {
+                    if (batchA[i])
+                        batched.push_back(modifier->Lerp(((Key*)batchA[i])->translate.x, ((Key*)batchB[i])->translate.x, F[i]));
+                }
+            }
+            xxGetCurrentTime(&end);
+            double batchTime = (end - begin) * 1000000000.0 / (times.size() * CHANNEL_COUNT);
+
+            bool match = reference == single && reference == batched;
+            step += snprintf(text + step, count - step, "%s : Linear %.1fns, Cursor %.1fns, Batch %.1fns, %s\n", seek ? "Seek" : "Play", linearTime, cursorTime, batchTime, match ? "Match" : "Mismatch");
+        }
+    }
+}
+//------------------------------------------------------------------------------
+static size_t FileSize(std::string const& name)
+{
+    size_t size = 0;
+    xxFile* file = xxFile::Load(name.c_str());
+    if (file)
+    {
+        size = file->Size();
+        delete file;
+    }
+    return size;
+}
+//------------------------------------------------------------------------------
+void BenchmarkCompression(char* text, size_t count)
+{
+    int step = 0;
+
+    // Chunked round trip
+    std::vector<uint8_t> vertex(COMPRESSION_SIZE);
+    std::vector<uint8_t> string(COMPRESSION_SIZE);
+    std::vector<uint8_t> noise(COMPRESSION_SIZE);
+    unsigned int random = 1;
+    for (size_t i = 0; i < COMPRESSION_SIZE / sizeof(float); ++i)
+    {
+        float value = float(i % 3 == 2 ? 0 : (i / 3) % 256) * 0.25f;
+        memcpy(&vertex[i * sizeof(float)], &value, sizeof(float));
+    }
+    for (size_t i = 0; i < COMPRESSION_SIZE; ++i)
+    {
+        random = random * 1664525 + 1013904223;
+        string[i] = "Bone Mesh Material Texture\n"[i % 27];
+        noise[i] = uint8_t(random >> 24);
+    }
+    struct { char const* name; std::vector<uint8_t> const& data; } const sets[] = { { "Vertex", vertex }, { "String", string }, { "Noise", noise } };
+    for (auto const& set : sets)
+    {
+        std::vector<uint8_t> compressed(Compression::Bound(Binary::ChunkSize) * (COMPRESSION_SIZE / Binary::ChunkSize));
+        std::vector<uint8_t> decompressed(COMPRESSION_SIZE);
+        std::vector<size_t> lengths;
+        size_t total = 0;
+        double begin = 0.0;
+        double end = 0.0;
+
+        xxGetCurrentTime(&begin);
+        for (size_t i = 0; i < COMPRESSION_SIZE; i += Binary::ChunkSize)
+        {
+            size_t length = Compression::Compress(set.data.data() + i, Binary::ChunkSize, compressed.data() + total, compressed.size() - total);
+            lengths.push_back(length);
+            total += length;
+        }
+        xxGetCurrentTime(&end);
+        double compress = COMPRESSION_SIZE / ((end - begin) * 1000000.0);
+
+        bool match = true;
+        size_t offset = 0;
+        xxGetCurrentTime(&begin);
+        for (size_t i = 0; i < lengths.size(); ++i)
+        {
+            if (Compression::Decompress(compressed.data() + offset, lengths[i], decompressed.data() + i * Binary::ChunkSize, Binary::ChunkSize) != Binary::ChunkSize)
+                match = false;
+            offset += lengths[i];
+        }
+        xxGetCurrentTime(&end);
+        double decompress = COMPRESSION_SIZE / ((end - begin) * 1000000.0);
+        match = match && decompressed == set.data;
+
+        step += snprintf(text + step, count - step, "%s : %.1f%%, Compress %.0fMB/s, Decompress %.0fMB/s, %s\n", set.name, total * 100.0 / COMPRESSION_SIZE, compress, decompress, match ? "Match" : "Mismatch");
+    }
+
+    // Scene round trip through plain and compressed .xxb
+    xxMeshPtr mesh = xxMesh::Create(false, 1, 0, 1);
+    mesh->SetVertexCount(COMPRESSION_SIZE / mesh->Stride[xxMesh::VERTEX]);
+    memcpy(mesh->Storage[xxMesh::VERTEX], vertex.data(), size_t(mesh->Count[xxMesh::VERTEX]) * mesh->Stride[xxMesh::VERTEX]);
+    xxNodePtr root = CreateHierarchy(1000);
+    root->Mesh = mesh;
+
+    std::string path = xxGetDocumentPath();
+    for (bool compress : { false, true })
+    {
+        std::string name = path + (compress ? "/.minamoto.benchmark.lz4.xxb" : "/.minamoto.benchmark.xxb");
+        double begin = 0.0;
+        double end = 0.0;
+        xxGetCurrentTime(&begin);
+        bool saved = Binary::Save(name.c_str(), root, compress);
+        xxGetCurrentTime(&end);
+        double save = (end - begin) * 1000.0;
+
+        xxGetCurrentTime(&begin);
+        xxNodePtr load = Binary::Load(name.c_str(), true);
+        xxGetCurrentTime(&end);
+        double elapsed = (end - begin) * 1000.0;
+
+        size_t nodeCount = 0;
+        size_t loadCount = 0;
+        Node::Traversal(root, [&](xxNodePtr const&) { nodeCount++; return true; });
+        if (load)
+            Node::Traversal(load, [&](xxNodePtr const&) { loadCount++; return true; });
+        bool match = saved && load && load->Mesh && nodeCount == loadCount;
+        if (match)
+        {
+            size_t size = size_t(mesh->Count[xxMesh::VERTEX]) * mesh->Stride[xxMesh::VERTEX];
+            match = load->Mesh->Count[xxMesh::VERTEX] == mesh->Count[xxMesh::VERTEX] && memcmp(load->Mesh->Storage[xxMesh::VERTEX], mesh->Storage[xxMesh::VERTEX], size) == 0;
+        }
+
+        step += snprintf(text + step, count - step, "%s : %zu bytes, Save %.3fms, Load %.3fms, %s\n", compress ? "Compressed" : "Plain", FileSize(name), save, elapsed, match ? "Match" : "Mismatch");
+        remove(name.c_str());
+    }
+}
+//------------------------------------------------------------------------------
+static double AngleError(xxVector4 const& A, xxVector4 const& B)
+{
+    double a[4] = { A.x, A.y, A.z, A.w };
+    double b[4] = { B.x, B.y, B.z, B.w };
+    double lengthA = 0.0;
+    double lengthB = 0.0;
+    double dot = 0.0;
+    for (int i = 0; i < 4; ++i)
+    {
+        lengthA += a[i] * a[i];
+        lengthB += b[i] * b[i];
+        dot += a[i] * b[i];
+    }
+    double sign = dot < 0.0 ? -1.0 : 1.0;
+    double minus = 0.0;
+    double plus = 0.0;
+    for (int i = 0; i < 4; ++i)
+    {
+        double x = a[i] / std::sqrt(lengthA);
+        double y = b[i] * sign / std::sqrt(lengthB);
+        minus += (x - y) * (x - y);
+        plus += (x + y) * (x + y);
+    }
+    return 4.0 * std::atan2(std::sqrt(minus), std::sqrt(plus)) * 180.0 / M_PI;
+}
+//------------------------------------------------------------------------------
+static xxVector4 ExactSlerp(xxVector4 const& A, xxVector4 const& B, double F)
+{
+    double a[4] = { A.x, A.y, A.z, A.w };
+    double b[4] = { B.x, B.y, B.z, B.w };
+    double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    double sign = dot < 0.0 ? -1.0 : 1.0;
+    double theta = std::acos(std::min(1.0, dot * sign));
+    double scaleA = 1.0 - F;
+    double scaleB = F * sign;
+    if (theta > 1.0e-6)
+    {
+        scaleA = std::sin((1.0 - F) * theta) / std::sin(theta);
+        scaleB = std::sin(F * theta) / std::sin(theta) * sign;
+    }
+    return { float(a[0] * scaleA + b[0] * scaleB), float(a[1] * scaleA + b[1] * scaleB), float(a[2] * scaleA + b[2] * scaleB), float(a[3] * scaleA + b[3] * scaleB) };
+}
+//------------------------------------------------------------------------------
+static xxVector4 RandomQuaternion(unsigned int& random)
+{
+    float v[4];
+    for (float& value : v)
+    {
+        random = random * 1664525 + 1013904223;
+        value = (random >> 8) * 2.0f / (1 << 24) - 1.0f;
+    }
+    xxVector4 quaternion = { v[0], v[1], v[2], v[3] };
+    return quaternion / std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]);
+}
+//------------------------------------------------------------------------------
+void BenchmarkQuaternion(char* text, size_t count)
+{
+    int step = 0;
+
+    // Storage
+    unsigned int random = 1;
+    std::vector<xxVector4> source;
+    for (int i = 0; i < ROTATION_COUNT; ++i)
+    {
+        source.push_back(RandomQuaternion(random));
+    }
+    float duration = (ROTATION_COUNT - 1) / 30.0f;
+    auto fill = [&](size_t index, xxVector4& quaternion) { quaternion = source[index]; };
+    xxModifierPtr baked = BakedQuaternionModifier::Create(ROTATION_COUNT, duration, fill);
+    xxModifierPtr baked16 = BakedQuaternion16Modifier::Create(ROTATION_COUNT, duration, fill);
+    xxModifierPtr baked48 = BakedQuaternion48Modifier::Create(ROTATION_COUNT, duration, fill);
+    auto values16 = ((BakedQuaternion16Modifier::Baked*)baked16->Data.data())->values;
+    auto values48 = ((BakedQuaternion48Modifier::Baked*)baked48->Data.data())->values;
+
+    // Interpolation against exact slerp, keys apart by a fixed angle
+    auto modifier = (Modifier*)baked.get();
+    for (float degree : { 10.0f, 45.0f, 90.0f, 170.0f })
+    {
+        double lerpError = 0.0;
+        double slerpError = 0.0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            xxVector4 A = RandomQuaternion(random);
+            xxVector4 axis = RandomQuaternion(random);
+            axis.w = 0.0f;
+            axis = axis / axis.xyz.Length();
+            float half = degree * float(M_PI) / 360.0f;
+            xxVector4 R = { axis.x * sinf(half), axis.y * sinf(half), axis.z * sinf(half), cosf(half) };
+            xxVector4 B = { A.w * R.x + A.x * R.w + A.y * R.z - A.z * R.y,
+                            A.w * R.y - A.x * R.z + A.y * R.w + A.z * R.x,
+                            A.w * R.z + A.x * R.y - A.y * R.x + A.z * R.w,
+                            A.w * R.w - A.x * R.x - A.y * R.y - A.z * R.z };
+            for (int j = 0; j <= 20; ++j)
+            {
+                float F = j / 20.0f;
+                xxVector4 exact = ExactSlerp(A, B, F);
+                lerpError = std::max(lerpError, AngleError(exact, modifier->Lerp(A, B, F)));
+                slerpError = std::max(slerpError, AngleError(exact, Modifier::Slerp(A, B, F)));
+                slerpError = std::max(slerpError, AngleError(exact, Modifier::Slerp(A, -B, F)));
+            }
+        }
+        step += snprintf(text + step, count - step, "Keys %.0f degrees apart : Lerp %.4f, Slerp %.4f degrees\n", degree, lerpError, slerpError);
+    }
+
+    // Quantization
+    double error16 = 0.0;
+    double error48 = 0.0;
+    for (int i = 0; i < ROTATION_COUNT; ++i)
+    {
+        xxVector4 quaternion16 = { __builtin_convertvector((v4hi&)values16[i], v4sf) };
+        error16 = std::max(error16, AngleError(source[i], quaternion16 / INT16_MAX));
+        error48 = std::max(error48, AngleError(source[i], BakedQuaternion48Modifier::Decode(values48[i])));
+    }
+
+    // Decode
+    double begin = 0.0;
+    double end = 0.0;
+    xxVector4 sum16 = xxVector4::ZERO;
+    xxVector4 sum48 = xxVector4::ZERO;
+    xxGetCurrentTime(&begin);
+    for (int i = 0; i < ROTATION_COUNT; ++i)
+    {
+        sum16 += xxVector4{ __builtin_convertvector((v4hi&)values16[i], v4sf) } / INT16_MAX;
+    }
+    xxGetCurrentTime(&end);
+    double decode16 = (end - begin) * 1000000000.0 / ROTATION_COUNT;
+    xxGetCurrentTime(&begin);
+    for (int i = 0; i < ROTATION_COUNT; ++i)
+    {
+        sum48 += BakedQuaternion48Modifier::Decode(values48[i]);
+    }
+    xxGetCurrentTime(&end);
+    double decode48 = (end - begin) * 1000000000.0 / ROTATION_COUNT;
+
+    // Update
+    double updates[3] = {};
+    xxModifierPtr modifiers[3] = { baked, baked16, baked48 };
+    xxNodePtr node = xxNode::Create();
+    for (int i = 0; i < 3; ++i)
+    {
+        xxModifierData data(modifiers[i]);
+        xxGetCurrentTime(&begin);
+        for (int j = 0; j < ROTATION_COUNT; ++j)
+        {
+            modifiers[i]->Update(node.get(), 1.0f + j / 60.0f, &data);
+        }
+        xxGetCurrentTime(&end);
+        updates[i] = (end - begin) * 1000000000.0 / ROTATION_COUNT;
+    }
+
+    step += snprintf(text + step, count - step, "Baked : %zu bytes, Update %.1fns\n", baked->Data.size(), updates[0]);
+    step += snprintf(text + step, count - step, "Baked16 : %zu bytes, %.4f degrees, Decode %.1fns, Update %.1fns\n", baked16->Data.size(), error16, decode16, updates[1]);
+    step += snprintf(text + step, count - step, "Baked48 : %zu bytes, %.4f degrees, Decode %.1fns, Update %.1fns\n", baked48->Data.size(), error48, decode48, updates[2]);
+    step += snprintf(text + step, count - step, "Checksum : %.3f %.3f\n", sum16.x + sum16.y + sum16.z + sum16.w, sum48.x + sum48.y + sum48.z + sum48.w);
+}
+//------------------------------------------------------------------------------
+void BenchmarkUpdate(char* text, size_t count)
+{
+    int step = 0;
+    int threadCount = JobSystem::ThreadCount();
+
+    xxNodePtr root = CreateCrowd();
+    std::vector<Node*> nodes;
+    for (xxNodePtr const& node : (*root))
+    {
+        nodes.push_back(node.get());
+    }
+    step += snprintf(text + step, count - step, "Crowd : %d x %d bones\n", CROWD_COUNT, BONE_COUNT);
+
+    std::vector<xxMatrix4> reference;
+    std::vector<xxMatrix4> matrices;
+    double single = 0.0;
+    float time = 1.0f;
+    for (int threads : { 1, 2, 4, 8 })
+    {
+        JobSystem::Initialize(threads);
+
+        double begin = 0.0;
+        double end = 0.0;
+        xxGetCurrentTime(&begin);
+        for (int i = 0; i < FRAME_COUNT; ++i)
+        {
+            time += 1.0f / 60.0f;
+            NodeTools::Update(nodes, time);
+        }
+        xxGetCurrentTime(&end);
+        double elapsed = (end - begin) * 1000.0 / FRAME_COUNT;
+        if (single == 0.0)
+            single = elapsed;
+
+        // Same time from a different previous state must give the same bits
+        NodeTools::Update(nodes, 1000.0f + threads);
+        NodeTools::Update(nodes, 1000.0f);
+        Capture(root, matrices);
+        if (reference.empty())
+            reference = matrices;
+        bool match = reference.size() == matrices.size() && memcmp(reference.data(), matrices.data(), sizeof(xxMatrix4) * matrices.size()) == 0;
+
+        step += snprintf(text + step, count - step, "Threads : %d, %.3fms, x%.2f, %s\n", threads, elapsed, single / elapsed, match ? "Deterministic" : "Mismatch");
+    }
+
+    JobSystem::Initialize(threadCount);
+}
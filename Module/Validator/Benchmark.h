@@ -0,0 +1,18 @@
+//==============================================================================
+// Minamoto : Benchmark Header
+//
+// Copyright (c) 2023-2026 TAiGA
+// https://github.com/NyankoLab/Minamoto
+//==============================================================================
+#pragma once
+
+#include <stddef.h>
+
+void BenchmarkCull(char* text, size_t count);
+void BenchmarkObject(char* text, size_t count);
+void BenchmarkTraversal(char* text, size_t count);
+void BenchmarkMatrix(char* text, size_t count);
+void BenchmarkSample(char* text, size_t count);
+void BenchmarkQuaternion(char* text, size_t count);
+void BenchmarkCompression(char* text, size_t count);
+void BenchmarkUpdate(char* text, size_t count);
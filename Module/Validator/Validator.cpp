@@ -9,6 +9,13 @@
 #include <xxGraphicPlus/xxFile.h>
 #include <xxGraphicPlus/xxMath.h>
 #include <xxGraphicPlus/xxNode.h>
+#include <xxGraphicPlus/xxTexture.h>
+
+#include <Graphic/Texture.h>
+
+#include <map>
+
+#include "Benchmark.h"
 
 #if DirectXMath
 #include "DirectXMath.h"
@@ -21,6 +28,7 @@ using namespace DirectX;
 
 static void ValidateFile(float time, char* text, size_t count);
 static void ValidateNode(float time, char* text, size_t count);
+static void ValidateTexture(char* text, size_t count);
 
 //------------------------------------------------------------------------------
 moduleAPI const char* Create(const CreateData& createData)
@@ -36,6 +44,7 @@ moduleAPI void Shutdown(const ShutdownData& shutdownData)
 moduleAPI bool Update(const UpdateData& updateData)
 {
     static bool showValidate = false;
+    static bool showBenchmark = false;
     static bool showAbout = false;
     static bool showBoundIntersect = false;
 
@@ -44,6 +53,7 @@ moduleAPI bool Update(const UpdateData& updateData)
         if (ImGui::BeginMenu(PLUGIN_NAME))
         {
             ImGui::MenuItem("Validate", nullptr, &showValidate);
+            ImGui::MenuItem("Benchmark", nullptr, &showBenchmark);
             ImGui::Separator();
             ImGui::MenuItem("Bound Intersect", nullptr, &showBoundIntersect);
             ImGui::Separator();
@@ -70,6 +80,62 @@ moduleAPI bool Update(const UpdateData& updateData)
             {
                 ValidateNode(updateData.time, text, sizeof(text));
             }
+            ImGui::SameLine();
+            if (ImGui::Button("Texture"))
+            {
+                ValidateTexture(text, sizeof(text));
+            }
+        }
+        ImGui::End();
+    }
+
+    if (showBenchmark)
+    {
+        ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("Benchmark", &showBenchmark, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking))
+        {
+            static char text[4096];
+            ImGui::InputTextMultiline("##source", text, IM_ARRAYSIZE(text), ImVec2(-FLT_MIN, ImGui::GetTextLineHeight() * 16), ImGuiInputTextFlags_ReadOnly);
+
+            if (ImGui::Button("Update"))
+            {
+                BenchmarkUpdate(text, sizeof(text));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Cull"))
+            {
+                BenchmarkCull(text, sizeof(text));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Object"))
+            {
+                BenchmarkObject(text, sizeof(text));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Traversal"))
+            {
+                BenchmarkTraversal(text, sizeof(text));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Matrix"))
+            {
+                BenchmarkMatrix(text, sizeof(text));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Sample"))
+            {
+                BenchmarkSample(text, sizeof(text));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Quaternion"))
+            {
+                BenchmarkQuaternion(text, sizeof(text));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Compression"))
+            {
+                BenchmarkCompression(text, sizeof(text));
+            }
         }
         ImGui::End();
     }
@@ -266,3 +332,121 @@ void ValidateNode(float time, char* text, size_t count)
 #endif
 }
 //------------------------------------------------------------------------------
+void ValidateTexture(char* text, size_t count)
+{
+    int step = 0;
+
+    // 1. Round trip through KTX2
+    static uint64_t const formats[] =
+    {
+        "RGBA8888"_CC,
+        "RGB10A2"_CC,
+        "RGBA16F"_CC,
+        "RGBA32F"_CC,
+        "BC1"_cc,
+        "BC7"_cc,
+        "ASTC44"_CC,
+        "ASTC66"_CC,
+        "ASTC1212"_CC,
+    };
+    std::string path = xxGetDocumentPath();
+    std::string name = ".minamoto.validate.ktx2";
+    for (uint64_t format : formats)
+    {
+        xxTexturePtr source = xxTexture::Create(format, 60, 36, 1, 6, 1);
+        for (int mipmap = 0; mipmap < source->Mipmap; ++mipmap)
+        {
+            size_t size = Texture::Calculate(format, std::max(60 >> mipmap, 1), std::max(36 >> mipmap, 1), 1);
+            memset((*source)(0, 0, 0, mipmap), mipmap + 1, size);
+        }
+        Texture::KTX2Writer(source, path + '/' + name);
+
+        xxTexturePtr target = xxTexture::Create();
+        target->Name = name;
+        target->Path = path;
+        Texture::Reader(target);
+        bool match = target->Format == format && target->Width == 60 && target->Height == 36 && target->Mipmap == 6;
+        for (int mipmap = 0; mipmap < target->Mipmap && match; ++mipmap)
+        {
+            size_t size = Texture::Calculate(format, std::max(60 >> mipmap, 1), std::max(36 >> mipmap, 1), 1);
+            match = memcmp((*source)(0, 0, 0, mipmap), (*target)(0, 0, 0, mipmap), size) == 0;
+        }
+        step += snprintf(text + step, count - step, "KTX2 %.8s : %s\n", (char*)&format, match ? "TRUE" : "FALSE");
+    }
+    remove((path + '/' + name).c_str());
+
+    // 2. Reference files against KTX2/expected.txt
+    //    <filename> <format> <width> <height> <depth> <mipmap> <array> <FNV-1a of every level>
+    //    <documents>/KTX2 overrides the set committed next to this source
+    std::string folder = path + "/KTX2";
+    FILE* file = fopen((folder + "/expected.txt").c_str(), "rb");
+    if (file == nullptr)
+    {
+        folder = xxFile::GetPath(__FILE__) + "/resource/KTX2";
+        file = fopen((folder + "/expected.txt").c_str(), "rb");
+    }
+    std::map<std::string, std::string> expects;
+    if (file == nullptr)
+    {
+        step += snprintf(text + step, count - step, "KTX2/expected.txt : FALSE (missing)\n");
+    }
+    if (file)
+    {
+        char line[256];
+        while (fgets(line, sizeof(line), file))
+        {
+            char filename[128];
+            if (line[0] == '#' || sscanf(line, "%127s", filename) != 1)
+                continue;
+            std::string expect = line + strlen(filename);
+            expect.erase(0, expect.find_first_not_of(" \t"));
+            expect.erase(expect.find_last_not_of(" \t\r\n") + 1);
+            expects[filename] = expect;
+        }
+        fclose(file);
+    }
+    uint64_t handle = 0;
+    while (char* filename = xxOpenDirectory(&handle, folder.c_str(), nullptr))
+    {
+        if (strcasestr(filename, ".ktx2"))
+        {
+            xxTexturePtr texture = xxTexture::Create();
+            texture->Name = filename;
+            texture->Path = folder;
+            Texture::Reader(texture);
+
+            uint64_t hash = 0xCBF29CE484222325ull;
+            for (int array = 0; array < texture->Array && (*texture)(); ++array)
+            {
+                for (int mipmap = 0; mipmap < texture->Mipmap; ++mipmap)
+                {
+                    size_t size = Texture::Calculate(texture->Format, std::max(texture->Width >> mipmap, 1), std::max(texture->Height >> mipmap, 1), std::max(texture->Depth >> mipmap, 1));
+                    unsigned char const* data = (unsigned char const*)(*texture)(0, 0, 0, mipmap, array);
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        hash ^= data[i];
+                        hash *= 0x100000001B3ull;
+                    }
+                }
+            }
+
+            uint64_t format = texture->Format;
+            char actual[128];
+            snprintf(actual, sizeof(actual), "%.8s %d %d %d %d %d %016llX", (char*)&format, texture->Width, texture->Height, texture->Depth, texture->Mipmap, texture->Array, (unsigned long long)hash);
+            auto it = expects.find(filename);
+            char const* result = it == expects.end() ? "FALSE (unlisted)" : it->second == actual ? "TRUE" : "FALSE";
+            step = std::min<int>(step + snprintf(text + step, count - step, "%s : %s (%s)\n", filename, result, actual), int(count) - 1);
+            if (it != expects.end())
+                expects.erase(it);
+        }
+        xxFree(filename);
+    }
+    xxCloseDirectory(&handle);
+
+    // Every listed reference must exist
+    for (auto const& [filename, expect] : expects)
+    {
+        step = std::min<int>(step + snprintf(text + step, count - step, "%s : FALSE (missing)\n", filename.c_str()), int(count) - 1);
+    }
+}
+//------------------------------------------------------------------------------